@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////
+// accumulator_bench.cpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+// Benchmark: atomic vs privatized vs automatic atomic_vec_accumulator
+//
+// Build and run from the repository root:
+//
+//      g++ -std=c++11 -O2 -pthread -I. bench/accumulator_bench.cpp -o acc_bench
+//      ./acc_bench [threads]
+//
+// Every thread adds float vec3 values into the cells; the time includes the
+// adds (and the first touch of per-thread copies) and reduce(), not the
+// construction. Three access patterns are measured:
+//
+//  - few cells: 64 cells, every thread adds all over them;
+//  - hot cells: 1M cells, but 9 in 10 adds go to 16 of them (splatting
+//    forces onto a grid with a few crowded cells);
+//  - spread: 1M cells, adds spread uniformly.
+//
+// The table prints milliseconds (best of several runs) and the mode that
+// accumulate_auto ended up in. threads defaults to the hardware concurrency;
+// contention only shows with as many cores as threads.
+/////////////////////////////////////////////////
+
+#include "../vecAccumulator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using sbt::atomic_vec_accumulator;
+using sbt::fvec::vec3;
+
+namespace
+{
+
+const std::size_t adds = 1u << 20;     // per thread
+const unsigned int runs = 3u;
+
+// cell index sequence of every thread, drawn before timing
+std::vector<std::vector<std::size_t> > make_cells (
+    unsigned int threads, std::size_t cells, std::size_t hot)
+{
+    std::vector<std::vector<std::size_t> > seq(threads);
+    for(unsigned int t = 0; t < threads; t++)
+    {
+        std::mt19937 rng(t + 1u);
+        std::uniform_int_distribution<std::size_t> any(0, cells - 1u);
+        std::uniform_int_distribution<std::size_t> crowded(0, hot - 1u);
+        std::uniform_int_distribution<int> pick(0, 9);
+        seq[t].resize(adds);
+        for(std::size_t i = 0; i < adds; i++)
+            seq[t][i] = (hot && pick(rng) != 0) ? crowded(rng) * 4099u % cells
+                                                 : any(rng);
+    }
+    return seq;
+}
+
+double run (std::size_t cells, unsigned int threads, sbt::accumulate_mode mode,
+            const std::vector<std::vector<std::size_t> >& seq,
+            sbt::accumulate_mode& used)
+{
+    double best = 1e30;
+    for(unsigned int r = 0; r < runs; r++)
+    {
+        atomic_vec_accumulator<float, 3u> acc(cells, threads, mode);
+        const std::chrono::steady_clock::time_point t0 =
+            std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+        for(unsigned int t = 0; t < threads; t++)
+            pool.push_back(std::thread([&acc, &seq, t]()
+            {
+                const vec3 v(1.0f, 0.5f, 0.25f);
+                for(std::size_t i = 0; i < adds; i++)
+                    acc.add(t, seq[t][i], v);
+            }));
+        for(unsigned int t = 0; t < threads; t++)
+            pool[t].join();
+        acc.reduce();
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+        best = ms < best ? ms : best;
+        used = acc.mode();
+    }
+    return best;
+}
+
+const char* name (sbt::accumulate_mode mode)
+{
+    return mode == sbt::accumulate_atomic ? "atomic" : "privatized";
+}
+
+} //namespace
+
+int main (int argc, char** argv)
+{
+    unsigned int threads = argc > 1 ? std::atoi(argv[1])
+                                    : std::thread::hardware_concurrency();
+    if(threads == 0u)
+        threads = 1u;
+
+    struct pattern
+    {
+        const char* label;
+        std::size_t cells;
+        std::size_t hot;
+    };
+    const pattern patterns[] = {
+        { "few cells", 64u, 0u },
+        { "hot cells", 1u << 20, 16u },
+        { "spread", 1u << 20, 0u }
+    };
+
+    std::printf("ms for %u threads x %u float vec3 adds\n\n", threads,
+                unsigned(adds));
+    std::printf("%-10s %10s %12s %10s  %s\n",
+                "pattern", "atomic", "privatized", "auto", "auto chose");
+    for(unsigned int p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+    {
+        const std::vector<std::vector<std::size_t> > seq =
+            make_cells(threads, patterns[p].cells, patterns[p].hot);
+        sbt::accumulate_mode used;
+        const double atomic = run(patterns[p].cells, threads,
+                                  sbt::accumulate_atomic, seq, used);
+        const double privatized = run(patterns[p].cells, threads,
+                                      sbt::accumulate_privatized, seq, used);
+        const double automatic = run(patterns[p].cells, threads,
+                                     sbt::accumulate_auto, seq, used);
+        std::printf("%-10s %10.1f %12.1f %10.1f  %s\n", patterns[p].label,
+                    atomic, privatized, automatic, name(used));
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/////////////////////////////////////////////////
+// cached_vec_bench.cpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+// Benchmark: when does cached_vec pay off over plain vec?
+//
+// Build and run from the repository root:
+//
+//      g++ -std=c++11 -O2 -I. bench/cached_vec_bench.cpp -o cached_vec_bench
+//      ./cached_vec_bench
+//
+// Every step writes each vector once, then reads norm() and normalize()
+// R times. The write is either a component write (drops the cache), a
+// scaling (keeps the cache, scaled), or a scaling followed by invalidate()
+// (what scaling would cost if it dropped the cache). Reads are done in two
+// ways:
+//
+//  - inline: in the same loop as the write, so the compiler can merge the
+//    repeated vec computations itself;
+//  - call: through a function pointer, as when reads are spread over
+//    functions the compiler cannot see through.
+//
+// The table prints nanoseconds per vector and step (best of several runs).
+// cached_vec pays off where its column is smaller than the vec column.
+/////////////////////////////////////////////////
+
+#include "../vecCached.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using sbt::cached_vec;
+using sbt::fvec::vec3;
+
+namespace
+{
+
+const unsigned int count = 1u << 16;
+const unsigned int steps = 20u;
+const unsigned int runs = 5u;
+
+float read_vec (const vec3& v)
+{
+    return v.norm() + v.normalize()[1];
+}
+
+float read_cached (const cached_vec<float, 3u>& v)
+{
+    return v.norm() + v.normalize()[1];
+}
+
+// volatile so that the calls cannot be inlined
+float (* volatile call_vec)(const vec3&) = read_vec;
+float (* volatile call_cached)(const cached_vec<float, 3u>&) = read_cached;
+
+volatile float sink;
+
+template <typename F>
+double best_ns (F f)
+{
+    double best = 1e30;
+    for(unsigned int r = 0; r < runs; r++)
+    {
+        const std::chrono::steady_clock::time_point t0 =
+            std::chrono::steady_clock::now();
+        f();
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - t0).count();
+        best = ns < best ? ns : best;
+    }
+    return best / (double(count) * steps);
+}
+
+template <bool Inline>
+double run_vec (std::vector<vec3> p, unsigned int reads)
+{
+    return best_ns([&]()
+    {
+        float acc = 0.0f;
+        for(unsigned int s = 0; s < steps; s++)
+            for(unsigned int i = 0; i < count; i++)
+            {
+                p[i][0] = p[i][0] + 1e-3f;
+                float sum = 0.0f;
+                for(unsigned int k = 0; k < reads; k++)
+                    sum += Inline ? read_vec(p[i]) : call_vec(p[i]);
+                acc += sum;
+            }
+        sink = acc;
+    });
+}
+
+enum write_mode
+{
+    component_write,
+    scale,
+    scale_invalidate
+};
+
+template <bool Inline, write_mode Mode>
+double run_cached (const std::vector<vec3>& init, unsigned int reads)
+{
+    std::vector<cached_vec<float, 3u> > p(init.begin(), init.end());
+    return best_ns([&]()
+    {
+        float acc = 0.0f;
+        for(unsigned int s = 0; s < steps; s++)
+            for(unsigned int i = 0; i < count; i++)
+            {
+                if(Mode == component_write)
+                    p[i][0] += 1e-3f;
+                else
+                    p[i] *= 1.0001f;
+                if(Mode == scale_invalidate)
+                    p[i].invalidate();
+                // summed per vector, so that acc is not spilled around an
+                // out-of-line write
+                float sum = 0.0f;
+                for(unsigned int k = 0; k < reads; k++)
+                    sum += Inline ? read_cached(p[i]) : call_cached(p[i]);
+                acc += sum;
+            }
+        sink = acc;
+    });
+}
+
+} //namespace
+
+int main ()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    std::vector<vec3> p(count);
+    for(unsigned int i = 0; i < count; i++)
+        p[i] = vec3(u(rng), u(rng), u(rng));
+
+    std::printf("ns per vector and step, %u float vec3, %u steps\n\n",
+                count, steps);
+    std::printf("%-6s %-7s %8s %14s %14s %14s\n", "reads", "access", "vec",
+                "cached(write)", "cached(scale)", "scale+drop");
+
+    const unsigned int reads[] = { 1u, 2u, 4u, 8u, 16u };
+    for(unsigned int r = 0; r < sizeof(reads) / sizeof(reads[0]); r++)
+    {
+        std::printf("%-6u %-7s %8.2f %14.2f %14.2f %14.2f\n", reads[r],
+                    "inline", run_vec<true>(p, reads[r]),
+                    run_cached<true, component_write>(p, reads[r]),
+                    run_cached<true, scale>(p, reads[r]),
+                    run_cached<true, scale_invalidate>(p, reads[r]));
+        std::printf("%-6u %-7s %8.2f %14.2f %14.2f %14.2f\n", reads[r],
+                    "call", run_vec<false>(p, reads[r]),
+                    run_cached<false, component_write>(p, reads[r]),
+                    run_cached<false, scale>(p, reads[r]),
+                    run_cached<false, scale_invalidate>(p, reads[r]));
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+#ifndef vec_aabb_HPP_
+#define vec_aabb_HPP_
+
+/////////////////////////////////////////////////
+// vecAabb.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// aabb<T, L> is an axis aligned bounding box given by its lower and upper
+// corner. An empty box has lower > upper, so extending it by any point gives
+// the box around that point.
+//
+// The bulk functions are written so that the compiler can vectorize them
+// without intrinsics:
+//
+//  - building a box from many points keeps 8 running minima/maxima per
+//    component and merges them at the end, so the inner loop is a
+//    lane-wise min/max instead of a loop-carried reduction (which compilers
+//    only vectorize for floating point with -ffast-math).
+//
+//  - cull() works on boxes stored as component arrays (aabb_soa). For each
+//    plane the corner of a box furthest along the plane normal (the
+//    "positive vertex") comes from the same array (lower or upper) for every
+//    box, so the test of a block of 64 boxes against one plane is a
+//    branch-free multiply-add over contiguous arrays, 8 or 16 boxes per SIMD
+//    instruction depending on the target. A block stops testing planes as
+//    soon as all of its boxes are culled, which happens often when the boxes
+//    are sorted spatially (see vecMorton.hpp).
+//
+/////////////////////////////////////////////////
+
+
+//=============================================//
+// INCLUDE vec (prototype, implementation and aliases)
+//=============================================//
+#include "vecDefault.hpp"
+#include "vecSoa.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace sbt
+{
+
+/////////////////////////////////////////////////
+/// \brief Axis aligned bounding box
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+class aabb
+{
+private:
+    vec<T, L> lo;
+    vec<T, L> hi;
+public:
+    /////////////////////////////////////////////////
+    /// \brief Empty box
+    ///
+    /////////////////////////////////////////////////
+    aabb ();
+
+    /////////////////////////////////////////////////
+    /// \brief Box with the given corners
+    ///
+    /////////////////////////////////////////////////
+    aabb (const vec<T, L>& lower, const vec<T, L>& upper);
+
+    /////////////////////////////////////////////////
+    /// \brief Box around an array of points (empty if n == 0)
+    ///
+    /// \param p array of n points
+    /// \param n number of points
+    ///
+    /////////////////////////////////////////////////
+    aabb (const vec<T, L>* p, std::size_t n);
+
+    /////////////////////////////////////////////////
+    /// \brief Box around points stored as component arrays
+    ///
+    /////////////////////////////////////////////////
+    aabb (const vec_soa<T, L>& p);
+
+    const vec<T, L>& lower () const;
+    const vec<T, L>& upper () const;
+
+    /////////////////////////////////////////////////
+    /// \brief `true` if the box contains no point
+    ///
+    /////////////////////////////////////////////////
+    bool empty () const;
+
+    /////////////////////////////////////////////////
+    /// \brief `true` if p is inside or on the boundary of the box
+    ///
+    /////////////////////////////////////////////////
+    bool contains (const vec<T, L>& p) const;
+
+    /////////////////////////////////////////////////
+    /// \brief `true` if the boxes share at least one point
+    ///
+    /////////////////////////////////////////////////
+    bool intersects (const aabb<T, L>& b) const;
+
+    /////////////////////////////////////////////////
+    /// \brief Grow the box to contain p
+    ///
+    /////////////////////////////////////////////////
+    void extend (const vec<T, L>& p);
+
+    /////////////////////////////////////////////////
+    /// \brief Grow the box to contain b
+    ///
+    /////////////////////////////////////////////////
+    void extend (const aabb<T, L>& b);
+
+    /////////////////////////////////////////////////
+    /// \brief Center of the box
+    ///
+    /////////////////////////////////////////////////
+    vec<T, L> center () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Size of the box along each axis (upper - lower)
+    ///
+    /////////////////////////////////////////////////
+    vec<T, L> extent () const;
+}; //class aabb
+
+/////////////////////////////////////////////////
+/// \brief An array of aabb<T, L> stored as component arrays
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+class aabb_soa
+{
+public:
+    vec_soa<T, L> lo;   ///< lower corners
+    vec_soa<T, L> hi;   ///< upper corners
+
+    std::size_t size () const;
+    void reserve (std::size_t n);
+    void clear ();
+    void push_back (const aabb<T, L>& b);
+
+    /////////////////////////////////////////////////
+    /// \brief Gather box n
+    /// \warning This method does not check the index to be in bounds
+    ///
+    /////////////////////////////////////////////////
+    aabb<T, L> get (std::size_t n) const;
+}; //class aabb_soa
+
+/////////////////////////////////////////////////
+/// \brief Test boxes against a set of planes (e.g. a view frustum)
+///
+/// A plane (a, b, c, d) keeps the points with a x + b y + c z + d >= 0,
+/// i.e. plane normals point into the frustum. A box is culled if it lies
+/// completely outside at least one plane. Boxes that are outside the frustum
+/// but not fully outside any single plane are kept (the usual conservative
+/// plane test).
+///
+/// \param planes array of plane equations
+/// \param count number of planes
+/// \param boxes boxes to test
+/// \param [out] mask (boxes.size() + 63) / 64 words; bit i % 64 of word
+///     i / 64 is set if box i is kept
+/// \return number of boxes kept
+///
+/////////////////////////////////////////////////
+template <typename T>
+std::size_t cull (const vec<T, 4u>* planes, unsigned int count,
+                  const aabb_soa<T, 3u>& boxes, unsigned long long* mask);
+
+/////////////////////////////////////////////////
+/// \brief Test boxes against a set of planes
+/// \see cull(const vec<T, 4u>*, unsigned int, const aabb_soa<T, 3u>&,
+///     unsigned long long*)
+///
+/// \param [out] mask resized to (boxes.size() + 63) / 64 words
+///
+/////////////////////////////////////////////////
+template <typename T>
+std::size_t cull (const std::vector<vec<T, 4u> >& planes,
+                  const aabb_soa<T, 3u>& boxes,
+                  std::vector<unsigned long long>& mask);
+
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecAabb.inl"
+
+#endif //vec_aabb_HPP_
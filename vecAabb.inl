@@ -0,0 +1,351 @@
+/////////////////////////////////////////////////
+//vecAabb.inl
+// Note: do not include this file directly, include vecAabb.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+#include <limits>
+
+namespace sbt
+{
+
+//=============================================//
+// Helpers
+//=============================================//
+namespace detail
+{
+
+// number of independent running minima/maxima in the bulk bounds loops
+const unsigned int aabb_lanes = 8u;
+
+// boxes per mask word in cull()
+const unsigned int cull_block = 64u;
+
+// minimum and maximum of x[0] ... x[n - 1], n > 0
+template <typename T>
+void bounds_lanes (const T* x, std::size_t n, T& lo, T& hi)
+{
+    T l[aabb_lanes], h[aabb_lanes];
+    for(unsigned int j = 0; j < aabb_lanes; j++)
+        l[j] = h[j] = x[0];
+
+    std::size_t i = 0;
+    for(; i + aabb_lanes <= n; i += aabb_lanes)
+        for(unsigned int j = 0; j < aabb_lanes; j++)
+        {
+            l[j] = x[i + j] < l[j] ? x[i + j] : l[j];
+            h[j] = h[j] < x[i + j] ? x[i + j] : h[j];
+        }
+    for(; i < n; i++)
+    {
+        l[0] = x[i] < l[0] ? x[i] : l[0];
+        h[0] = h[0] < x[i] ? x[i] : h[0];
+    }
+
+    lo = l[0];
+    hi = h[0];
+    for(unsigned int j = 1; j < aabb_lanes; j++)
+    {
+        lo = l[j] < lo ? l[j] : lo;
+        hi = hi < h[j] ? h[j] : hi;
+    }
+} //bounds_lanes(T*, size_t, T&, T&)
+
+// same for the points p[0] ... p[n - 1], n > 0
+template <typename T, unsigned int L>
+void bounds_lanes (const vec<T, L>* p, std::size_t n,
+                   vec<T, L>& lo, vec<T, L>& hi)
+{
+    T l[L][aabb_lanes], h[L][aabb_lanes];
+    for(unsigned int k = 0; k < L; k++)
+        for(unsigned int j = 0; j < aabb_lanes; j++)
+            l[k][j] = h[k][j] = p[0][k];
+
+    std::size_t i = 0;
+    for(; i + aabb_lanes <= n; i += aabb_lanes)
+        for(unsigned int j = 0; j < aabb_lanes; j++)
+            for(unsigned int k = 0; k < L; k++)
+            {
+                const T x = p[i + j][k];
+                l[k][j] = x < l[k][j] ? x : l[k][j];
+                h[k][j] = h[k][j] < x ? x : h[k][j];
+            }
+    for(; i < n; i++)
+        for(unsigned int k = 0; k < L; k++)
+        {
+            const T x = p[i][k];
+            l[k][0] = x < l[k][0] ? x : l[k][0];
+            h[k][0] = h[k][0] < x ? x : h[k][0];
+        }
+
+    for(unsigned int k = 0; k < L; k++)
+    {
+        lo[k] = l[k][0];
+        hi[k] = h[k][0];
+        for(unsigned int j = 1; j < aabb_lanes; j++)
+        {
+            lo[k] = l[k][j] < lo[k] ? l[k][j] : lo[k];
+            hi[k] = hi[k] < h[k][j] ? h[k][j] : hi[k];
+        }
+    }
+} //bounds_lanes(vec*, size_t, vec&, vec&)
+
+// test boxes [base, base + m) against all planes and write their mask word.
+// M is m when known at compile time (full blocks) and 0 otherwise, so that
+// the loops over full blocks have a constant trip count and vectorize
+// without a scalar remainder.
+template <typename T, unsigned int M>
+unsigned int cull_block_planes (const vec<T, 4u>* planes, unsigned int count,
+                                const aabb_soa<T, 3u>& boxes,
+                                std::size_t base, std::size_t m,
+                                unsigned long long& word)
+{
+    const std::size_t n = M ? M : m;
+    unsigned char keep[cull_block];
+    for(unsigned int j = 0; j < cull_block; j++)
+        keep[j] = 1u;
+
+    for(unsigned int p = 0; p < count; p++)
+    {
+        const T a = planes[p][0], b = planes[p][1], c = planes[p][2];
+        const T d = planes[p][3];
+
+        // positive vertex: upper corner along axes where the normal is
+        // non-negative, lower corner otherwise
+        const T* x = &(a < T(0) ? boxes.lo : boxes.hi).c[0][base];
+        const T* y = &(b < T(0) ? boxes.lo : boxes.hi).c[1][base];
+        const T* z = &(c < T(0) ? boxes.lo : boxes.hi).c[2][base];
+
+        unsigned char any = 0u;
+        for(std::size_t j = 0; j < n; j++)
+        {
+            keep[j] &= (a * x[j] + b * y[j] + c * z[j] + d >= T(0));
+            any |= keep[j];
+        }
+        // the whole block is culled, the remaining planes cannot change that.
+        // The early exit also stops GCC -O3 from unroll-and-jamming the
+        // plane loop, which leaves the inner loop unvectorized.
+        if(!any)
+            break;
+    }
+
+    unsigned int kept = 0;
+    word = 0;
+    for(std::size_t j = 0; j < n; j++)
+    {
+        word |= static_cast<unsigned long long>(keep[j]) << j;
+        kept += keep[j];
+    }
+    return kept;
+} //cull_block_planes(vec4*, uint, aabb_soa, size_t, size_t, ull&)
+
+} //namespace detail
+
+
+//=============================================//
+// Class aabb
+//=============================================//
+
+template <typename T, unsigned int L>
+aabb<T, L>::aabb ()
+    : lo(std::numeric_limits<T>::max()), hi(std::numeric_limits<T>::lowest())
+{
+} //aabb()
+
+template <typename T, unsigned int L>
+aabb<T, L>::aabb (const vec<T, L>& lower, const vec<T, L>& upper)
+    : lo(lower), hi(upper)
+{
+} //aabb(vec, vec)
+
+template <typename T, unsigned int L>
+aabb<T, L>::aabb (const vec<T, L>* p, std::size_t n)
+    : lo(std::numeric_limits<T>::max()), hi(std::numeric_limits<T>::lowest())
+{
+    if(n)
+        detail::bounds_lanes(p, n, lo, hi);
+} //aabb(vec*, size_t)
+
+template <typename T, unsigned int L>
+aabb<T, L>::aabb (const vec_soa<T, L>& p)
+    : lo(std::numeric_limits<T>::max()), hi(std::numeric_limits<T>::lowest())
+{
+    if(p.size())
+        for(unsigned int k = 0; k < L; k++)
+            detail::bounds_lanes(&p.c[k][0], p.size(), lo[k], hi[k]);
+} //aabb(vec_soa)
+
+template <typename T, unsigned int L>
+const vec<T, L>& aabb<T, L>::lower () const
+{
+    return lo;
+} //lower()
+
+template <typename T, unsigned int L>
+const vec<T, L>& aabb<T, L>::upper () const
+{
+    return hi;
+} //upper()
+
+template <typename T, unsigned int L>
+bool aabb<T, L>::empty () const
+{
+    for(unsigned int i = 0; i < L; i++)
+        if(hi[i] < lo[i])
+            return true;
+    return false;
+} //empty()
+
+template <typename T, unsigned int L>
+bool aabb<T, L>::contains (const vec<T, L>& p) const
+{
+    for(unsigned int i = 0; i < L; i++)
+        if(p[i] < lo[i] || hi[i] < p[i])
+            return false;
+    return true;
+} //contains(vec)
+
+template <typename T, unsigned int L>
+bool aabb<T, L>::intersects (const aabb<T, L>& b) const
+{
+    for(unsigned int i = 0; i < L; i++)
+        if(b.hi[i] < lo[i] || hi[i] < b.lo[i])
+            return false;
+    return true;
+} //intersects(aabb)
+
+template <typename T, unsigned int L>
+void aabb<T, L>::extend (const vec<T, L>& p)
+{
+    for(unsigned int i = 0; i < L; i++)
+    {
+        lo[i] = p[i] < lo[i] ? p[i] : lo[i];
+        hi[i] = hi[i] < p[i] ? p[i] : hi[i];
+    }
+} //extend(vec)
+
+template <typename T, unsigned int L>
+void aabb<T, L>::extend (const aabb<T, L>& b)
+{
+    for(unsigned int i = 0; i < L; i++)
+    {
+        lo[i] = b.lo[i] < lo[i] ? b.lo[i] : lo[i];
+        hi[i] = hi[i] < b.hi[i] ? b.hi[i] : hi[i];
+    }
+} //extend(aabb)
+
+template <typename T, unsigned int L>
+vec<T, L> aabb<T, L>::center () const
+{
+    vec<T, L> temp;
+    for(unsigned int i = 0; i < L; i++)
+        temp[i] = (lo[i] + hi[i]) / T(2);
+    return temp;
+} //center()
+
+template <typename T, unsigned int L>
+vec<T, L> aabb<T, L>::extent () const
+{
+    vec<T, L> temp;
+    for(unsigned int i = 0; i < L; i++)
+        temp[i] = hi[i] - lo[i];
+    return temp;
+} //extent()
+
+
+//=============================================//
+// Class aabb_soa
+//=============================================//
+
+template <typename T, unsigned int L>
+std::size_t aabb_soa<T, L>::size () const
+{
+    return lo.size();
+} //size()
+
+template <typename T, unsigned int L>
+void aabb_soa<T, L>::reserve (std::size_t n)
+{
+    lo.reserve(n);
+    hi.reserve(n);
+} //reserve(size_t)
+
+template <typename T, unsigned int L>
+void aabb_soa<T, L>::clear ()
+{
+    lo.clear();
+    hi.clear();
+} //clear()
+
+template <typename T, unsigned int L>
+void aabb_soa<T, L>::push_back (const aabb<T, L>& b)
+{
+    lo.push_back(b.lower());
+    hi.push_back(b.upper());
+} //push_back(aabb)
+
+template <typename T, unsigned int L>
+aabb<T, L> aabb_soa<T, L>::get (std::size_t n) const
+{
+    return aabb<T, L>(lo.get(n), hi.get(n));
+} //get(size_t)
+
+
+//=============================================//
+// Culling
+//=============================================//
+
+template <typename T>
+std::size_t cull (const vec<T, 4u>* planes, unsigned int count,
+                  const aabb_soa<T, 3u>& boxes, unsigned long long* mask)
+{
+    const std::size_t n = boxes.size();
+    const std::size_t full = n / detail::cull_block * detail::cull_block;
+    std::size_t kept = 0;
+
+    for(std::size_t base = 0; base < full; base += detail::cull_block)
+        kept += detail::cull_block_planes<T, detail::cull_block>(
+                    planes, count, boxes, base, detail::cull_block,
+                    mask[base / detail::cull_block]);
+    if(full < n)
+        kept += detail::cull_block_planes<T, 0u>(
+                    planes, count, boxes, full, n - full,
+                    mask[full / detail::cull_block]);
+    return kept;
+} //cull(vec4*, uint, aabb_soa, ull*)
+
+template <typename T>
+std::size_t cull (const std::vector<vec<T, 4u> >& planes,
+                  const aabb_soa<T, 3u>& boxes,
+                  std::vector<unsigned long long>& mask)
+{
+    mask.resize((boxes.size() + detail::cull_block - 1u) / detail::cull_block);
+    return cull(planes.empty() ? 0 : &planes[0],
+                static_cast<unsigned int>(planes.size()), boxes,
+                mask.empty() ? 0 : &mask[0]);
+} //cull(vector<vec4>, aabb_soa, vector<ull>)
+
+} //namespace sbt
@@ -0,0 +1,202 @@
+#ifndef vec_accumulator_HPP_
+#define vec_accumulator_HPP_
+
+/////////////////////////////////////////////////
+// vecAccumulator.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// atomic_vec_accumulator is an array of vec<T, L> cells that many threads
+// can add into at once without locks. It works in one of two modes:
+//
+//  - atomic: every component of every cell is a std::atomic<T>, and add()
+//    does one compare-and-swap loop per component. This is cheap as long as
+//    threads rarely hit the same cell at the same time.
+//
+//  - privatized: every thread adds into its own plain copy of the cells, and
+//    reduce() sums the copies in parallel afterwards. There is no contention
+//    at all, but memory and reduction time grow with the number of threads.
+//
+// In automatic mode a small array (one copy fits in `private_bytes`, about
+// the size of a per-core L2 cache by default) is privatized from the start:
+// few cells is where threads collide most often, and copies are cheap.
+// Larger arrays start in atomic mode, and every thread counts its failed
+// compare-and-swaps. When a thread's last check_adds adds had more than one
+// failure per max_failed_ratio adds, all threads switch to their own copies
+// for the rest of the accumulator's life, so a large grid with a few hot cells
+// (force splatting) does not stay on contended atomics. reduce() then adds
+// the copies to what the atomics already hold. Switching allocates one copy
+// of all cells per thread; use accumulate_atomic where that does not fit.
+//
+// Adding and reading must not overlap: call reduce() and get() only after
+// all threads that add have been joined.
+//
+/////////////////////////////////////////////////
+
+
+//=============================================//
+// INCLUDE vec (prototype, implementation and aliases)
+//=============================================//
+#include "vecDefault.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace sbt
+{
+
+/////////////////////////////////////////////////
+/// \brief Add to an atomic with a compare-and-swap loop
+///
+/// std::atomic<T>::fetch_add is not available for floating point T before
+/// C++20, this works for any arithmetic T.
+///
+/// \param [in,out] target value to add to
+/// \param value value to add
+/// \return value of target before the addition
+///
+/////////////////////////////////////////////////
+template <typename T>
+T atomic_add (std::atomic<T>& target, const T value);
+
+/////////////////////////////////////////////////
+/// \brief How an atomic_vec_accumulator handles concurrent adds
+///
+/////////////////////////////////////////////////
+enum accumulate_mode
+{
+    accumulate_auto,        ///< choose by size and contention, see above
+    accumulate_atomic,      ///< per-component compare-and-swap
+    accumulate_privatized   ///< per-thread copies, summed by reduce()
+};
+
+/////////////////////////////////////////////////
+/// \brief Array of vec<T, L> cells that threads add into concurrently
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+class atomic_vec_accumulator
+{
+private:
+    accumulate_mode m;
+    std::size_t ncells;
+    unsigned int nthreads;
+    std::vector<std::atomic<T> > shared;    // atomic mode, cells * L
+    std::vector<std::vector<T> > shadow;    // privatized mode, one per thread,
+                                            // allocated by its first add()
+    std::vector<T> result;                  // privatized mode, after reduce()
+    std::atomic<bool> contended;            // automatic mode has switched
+    std::vector<std::size_t> stats;         // automatic mode, adds and failed
+                                            // compare-and-swaps per thread
+
+    enum
+    {
+        stats_stride = 16,      // keeps each thread's counters on their own
+                                // cache line
+        check_adds = 1024,      // adds between contention checks
+        max_failed_ratio = 8    // switch above 1 failure per 8 adds
+    };
+public:
+    /////////////////////////////////////////////////
+    /// \brief Create an accumulator with all cells zero
+    ///
+    /// \param cells number of cells
+    /// \param threads number of threads that will call add(), 0 = hardware
+    ///     concurrency
+    /// \param mode accumulation mode, accumulate_auto picks one (see above)
+    /// \param private_bytes largest size of one per-thread copy for which
+    ///     accumulate_auto privatizes from the start
+    ///
+    /////////////////////////////////////////////////
+    atomic_vec_accumulator (std::size_t cells, unsigned int threads = 0u,
+                            accumulate_mode mode = accumulate_auto,
+                            std::size_t private_bytes = 1u << 20);
+
+    /////////////////////////////////////////////////
+    /// \brief Add v to a cell
+    ///
+    /// \param thread index of the calling thread, in [0, threads)
+    /// \param cell index of the cell
+    /// \param v value to add
+    /// \warning This method does not check the indices to be in bounds
+    ///
+    /////////////////////////////////////////////////
+    void add (unsigned int thread, std::size_t cell, const vec<T, L>& v);
+
+    /////////////////////////////////////////////////
+    /// \brief Sum the per-thread copies (privatized mode)
+    ///
+    /// Does nothing in atomic mode. The per-thread copies are zero
+    /// afterwards, so adding can continue. In automatic mode the copies are
+    /// added to the atomic cells, so call it whatever mode() says.
+    ///
+    /// \param threads number of threads for the reduction, 0 = hardware
+    ///     concurrency
+    ///
+    /////////////////////////////////////////////////
+    void reduce (unsigned int threads = 0u);
+
+    /////////////////////////////////////////////////
+    /// \brief Value of a cell (after reduce() in privatized mode)
+    /// \exception out_of_range if cell is too large
+    ///
+    /////////////////////////////////////////////////
+    vec<T, L> get (std::size_t cell) const;
+
+    /////////////////////////////////////////////////
+    /// \brief Set all cells to zero
+    ///
+    /////////////////////////////////////////////////
+    void clear ();
+
+    /////////////////////////////////////////////////
+    /// \brief Mode in use (never accumulate_auto)
+    ///
+    /// In automatic mode this changes from accumulate_atomic to
+    /// accumulate_privatized when contention is detected.
+    ///
+    /////////////////////////////////////////////////
+    accumulate_mode mode () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Number of cells
+    ///
+    /////////////////////////////////////////////////
+    std::size_t size () const;
+}; //class atomic_vec_accumulator
+
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecAccumulator.inl"
+
+#endif //vec_accumulator_HPP_
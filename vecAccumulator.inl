@@ -0,0 +1,225 @@
+/////////////////////////////////////////////////
+//vecAccumulator.inl
+// Note: do not include this file directly, include vecAccumulator.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+#include "vecParallel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+namespace sbt
+{
+
+template <typename T>
+T atomic_add (std::atomic<T>& target, const T value)
+{
+    T expected = target.load(std::memory_order_relaxed);
+    // on failure `expected` is reloaded with the current value
+    while(!target.compare_exchange_weak(expected, expected + value,
+                                        std::memory_order_relaxed))
+        ;
+    return expected;
+} //atomic_add(atomic<T>, T)
+
+namespace detail
+{
+
+// atomic_add() that returns the number of failed compare-and-swap attempts
+template <typename T>
+std::size_t atomic_add_counted (std::atomic<T>& target, const T value)
+{
+    std::size_t failed = 0;
+    T expected = target.load(std::memory_order_relaxed);
+    while(!target.compare_exchange_weak(expected, expected + value,
+                                        std::memory_order_relaxed))
+        failed++;
+    return failed;
+} //atomic_add_counted(atomic<T>, T)
+
+} //namespace detail
+
+//=============================================//
+// Class atomic_vec_accumulator
+//=============================================//
+
+template <typename T, unsigned int L>
+atomic_vec_accumulator<T, L>::atomic_vec_accumulator (
+    std::size_t cells, unsigned int threads, accumulate_mode mode,
+    std::size_t private_bytes)
+    : m(mode), ncells(cells), nthreads(threads)
+{
+    static_assert(std::is_arithmetic<T>::value,
+                  "atomic_vec_accumulator requires an arithmetic type");
+
+    if(nthreads == 0u)
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+    if(m == accumulate_auto)
+    {
+        const bool small = cells * L * sizeof(T) <= private_bytes;
+        if(nthreads == 1u)
+            m = accumulate_atomic;
+        else if(small)
+            m = accumulate_privatized;
+    }
+
+    contended.store(false, std::memory_order_relaxed);
+    if(m != accumulate_privatized)
+        std::vector<std::atomic<T> >(cells * L).swap(shared);
+    if(m != accumulate_atomic)
+        shadow.resize(nthreads);
+    if(m == accumulate_privatized)
+        result.resize(cells * L);
+    if(m == accumulate_auto)
+        stats.assign(nthreads * stats_stride, 0u);
+    clear();
+} //atomic_vec_accumulator(size_t, uint, accumulate_mode, size_t)
+
+template <typename T, unsigned int L>
+void atomic_vec_accumulator<T, L>::add (unsigned int thread, std::size_t cell,
+                                        const vec<T, L>& v)
+{
+    if(m == accumulate_atomic)
+    {
+        std::atomic<T>* d = &shared[cell * L];
+        for(unsigned int i = 0; i < L; i++)
+            atomic_add(d[i], v[i]);
+    }
+    else if(m == accumulate_auto && !contended.load(std::memory_order_relaxed))
+    {
+        std::atomic<T>* d = &shared[cell * L];
+        std::size_t failed = 0;
+        for(unsigned int i = 0; i < L; i++)
+            failed += detail::atomic_add_counted(d[i], v[i]);
+
+        // every check_adds adds, switch all threads to their own copies if
+        // too many compare-and-swaps failed
+        std::size_t* own = &stats[thread * stats_stride];
+        own[1] += failed;
+        if(++own[0] == check_adds)
+        {
+            if(own[1] * max_failed_ratio > check_adds)
+                contended.store(true, std::memory_order_relaxed);
+            own[0] = 0u;
+            own[1] = 0u;
+        }
+    }
+    else
+    {
+        // allocated here so that the pages are first touched by the thread
+        // that uses them
+        std::vector<T>& own = shadow[thread];
+        if(own.empty())
+            own.assign(ncells * L, T(0));
+        T* d = &own[cell * L];
+        for(unsigned int i = 0; i < L; i++)
+            d[i] += v[i];
+    }
+} //add(uint, size_t, vec)
+
+template <typename T, unsigned int L>
+void atomic_vec_accumulator<T, L>::reduce (unsigned int threads)
+{
+    if(m == accumulate_atomic)
+        return;
+
+    // automatic mode sums into the atomic cells, which already hold what was
+    // added before the switch; no thread adds during reduce()
+    const std::size_t n = ncells * L;
+    detail::parallel_chunks(n, detail::thread_count(threads, n, 1u << 14),
+        [this](std::size_t begin, std::size_t end, unsigned int)
+        {
+            for(unsigned int t = 0; t < shadow.size(); t++)
+            {
+                if(shadow[t].empty())
+                    continue;
+                T* s = &shadow[t][0];
+                if(m == accumulate_auto)
+                {
+                    for(std::size_t i = begin; i < end; i++)
+                    {
+                        shared[i].store(shared[i].load(
+                            std::memory_order_relaxed) + s[i],
+                            std::memory_order_relaxed);
+                        s[i] = T(0);
+                    }
+                }
+                else
+                {
+                    for(std::size_t i = begin; i < end; i++)
+                    {
+                        result[i] += s[i];
+                        s[i] = T(0);
+                    }
+                }
+            }
+        });
+} //reduce(uint)
+
+template <typename T, unsigned int L>
+vec<T, L> atomic_vec_accumulator<T, L>::get (std::size_t cell) const
+{
+    if(cell >= ncells)
+        throw std::out_of_range("cell too large");
+
+    vec<T, L> temp;
+    for(unsigned int i = 0; i < L; i++)
+        temp[i] = (m != accumulate_privatized)
+                ? shared[cell * L + i].load(std::memory_order_relaxed)
+                : result[cell * L + i];
+    return temp;
+} //get(size_t)
+
+template <typename T, unsigned int L>
+void atomic_vec_accumulator<T, L>::clear ()
+{
+    for(std::size_t i = 0; i < shared.size(); i++)
+        shared[i].store(T(0), std::memory_order_relaxed);
+    for(unsigned int t = 0; t < shadow.size(); t++)
+        std::fill(shadow[t].begin(), shadow[t].end(), T(0));
+    std::fill(result.begin(), result.end(), T(0));
+} //clear()
+
+template <typename T, unsigned int L>
+accumulate_mode atomic_vec_accumulator<T, L>::mode () const
+{
+    if(m != accumulate_auto)
+        return m;
+    return contended.load(std::memory_order_relaxed) ? accumulate_privatized
+                                                     : accumulate_atomic;
+} //mode()
+
+template <typename T, unsigned int L>
+std::size_t atomic_vec_accumulator<T, L>::size () const
+{
+    return ncells;
+} //size()
+
+} //namespace sbt
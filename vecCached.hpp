@@ -0,0 +1,236 @@
+#ifndef vec_cached_HPP_
+#define vec_cached_HPP_
+
+/////////////////////////////////////////////////
+// vecCached.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// cached_vec wraps a vec<T, L> and remembers its squared norm, norm and
+// normalized direction once they have been computed. Every write to the
+// components drops what is cached. The non-const operator[] returns a
+// write-through proxy instead of T&, so reading a component does not drop
+// the cache and a held reference cannot write behind its back. Negation
+// carries the cache over.
+//
+// Scaling by s keeps the norm (scaled by |s|) and the direction (kept or
+// flipped) when the old and the new norm are in the range where their
+// square is exact, and recomputes everything otherwise. This saves the
+// recomputation and nothing more: scaling is not cheaper than a component
+// write.
+//
+// Each cached value is computed the same way vec<T, L>::norm() and
+// vec<T, L>::normalize() compute it, so the results match vec exactly as
+// long as only component writes happen. Values updated by scaling may
+// differ from a recomputation by rounding.
+//
+// The cache only pays off if norm()/normalize() are called several times
+// between writes, and only where the reads are inlined. For float vec3 it
+// takes about 8 inline reads per write to beat plain vec. Reads through
+// calls the compiler cannot inline never gain: the call costs more than a
+// 3-d norm, whose sqrt and divides the CPU overlaps with the call anyway.
+// See bench/cached_vec_bench.cpp.
+//
+/////////////////////////////////////////////////
+
+
+//=============================================//
+// INCLUDE vec (prototype, implementation and aliases)
+//=============================================//
+#include "vecDefault.hpp"
+
+namespace sbt
+{
+
+/////////////////////////////////////////////////
+/// \brief A vec<T, L> that caches its norm and direction
+///
+/// Only for floating point T.
+///
+/// \warning norm2(), norm() and normalize() are const but fill the cache, so
+///     concurrent calls on the same object (even through const references)
+///     are a data race. Give each thread its own copies, or read the cache
+///     once before sharing the object.
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+class cached_vec
+{
+private:
+    enum
+    {
+        norm2_valid = 1u,
+        norm_valid = 2u,
+        unit_valid = 4u
+    };
+
+    vec<T, L> v;
+    mutable vec<T, L> unit;
+    mutable T n2;
+    mutable T n;
+    mutable unsigned int valid;
+
+    T update_norm2 () const;
+    T update_norm () const;
+    const vec<T, L>& update_unit () const;
+public:
+    /////////////////////////////////////////////////
+    /// \brief Write-through reference to one component
+    ///
+    /// Returned by the non-const operator[]. Assigning to it writes the
+    /// component and drops the cache; converting it to T only reads.
+    /// Unlike T&, it cannot be held on to and written behind the cache's
+    /// back.
+    ///
+    /////////////////////////////////////////////////
+    class component_ref
+    {
+    private:
+        cached_vec& owner;
+        const unsigned int index;
+    public:
+        component_ref (cached_vec& target, const unsigned int at);
+
+        operator T () const;
+        component_ref& operator= (const T value);
+        component_ref& operator= (const component_ref& other);
+        component_ref& operator+= (const T value);
+        component_ref& operator-= (const T value);
+        component_ref& operator*= (const T value);
+        component_ref& operator/= (const T value);
+    }; //class component_ref
+
+    cached_vec ();
+    cached_vec (const vec<T, L>& value);
+    cached_vec (T c0, T c1);
+    cached_vec (T c0, T c1, T c2);
+    cached_vec (T c0, T c1, T c2, T c3);
+
+    /////////////////////////////////////////////////
+    /// \brief The wrapped vector
+    ///
+    /////////////////////////////////////////////////
+    const vec<T, L>& value () const;
+    operator const vec<T, L>& () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Access component directly (via reference) read-only.
+    /// \param [in] index index of component (starting from 0)
+    /// \return Reference to component at index
+    /// \warning This method does not check the index to be in bounds
+    ///
+    /////////////////////////////////////////////////
+    const T& operator[] (const unsigned int index) const;
+
+    /////////////////////////////////////////////////
+    /// \brief Access component for writing.
+    ///
+    /// Returns a component_ref, which reads the component without touching
+    /// the cache and drops the cache when it is assigned to.
+    ///
+    /// \param [in] index index of component (starting from 0)
+    /// \return Proxy for component at index
+    /// \warning This method does not check the index to be in bounds
+    ///
+    /////////////////////////////////////////////////
+    component_ref operator[] (const unsigned int index);
+
+    /////////////////////////////////////////////////
+    /// \brief Set component at index, dropping the cache
+    /// \exception out_of_range if index is too large
+    ///
+    /////////////////////////////////////////////////
+    void set (const unsigned int index, const T value);
+
+    /////////////////////////////////////////////////
+    /// \brief Replace the wrapped vector, dropping the cache
+    ///
+    /////////////////////////////////////////////////
+    const cached_vec& operator= (const vec<T, L>& value);
+
+    cached_vec& operator+= (const vec<T, L>& value);
+    cached_vec& operator-= (const vec<T, L>& value);
+    cached_vec& operator*= (const vec<T, L>& value);
+
+    /////////////////////////////////////////////////
+    /// \brief Scale by s, updating the cache instead of dropping it
+    ///
+    /////////////////////////////////////////////////
+    cached_vec& operator*= (const T& s);
+
+    /////////////////////////////////////////////////
+    /// \brief Scaled copy, with the cache carried over
+    ///
+    /////////////////////////////////////////////////
+    cached_vec operator* (const T& s) const;
+
+    /////////////////////////////////////////////////
+    /// \brief Negated copy, with the cache carried over
+    ///
+    /////////////////////////////////////////////////
+    cached_vec operator- () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Squared norm, computed on first use after a write
+    ///
+    /////////////////////////////////////////////////
+    T norm2 () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Norm, computed on first use after a write
+    /// \see vec::norm()
+    ///
+    /////////////////////////////////////////////////
+    T norm () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Unit vector in the direction of the vector, computed on first
+    /// use after a write
+    /// \see vec::normalize()
+    ///
+    /////////////////////////////////////////////////
+    const vec<T, L>& normalize () const;
+
+    /////////////////////////////////////////////////
+    /// \brief Drop everything that is cached
+    ///
+    /////////////////////////////////////////////////
+    void invalidate ();
+
+    unsigned int length () const;
+}; //class cached_vec
+
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecCached.inl"
+
+#endif //vec_cached_HPP_
@@ -0,0 +1,314 @@
+/////////////////////////////////////////////////
+//vecCached.inl
+// Note: do not include this file directly, include vecCached.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sbt
+{
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::cached_vec ()
+    : v(T(0)), unit(T(0)), n2(0), n(0), valid(norm2_valid | norm_valid)
+{
+    static_assert(std::is_floating_point<T>::value,
+                  "cached_vec requires a floating point type");
+} //cached_vec()
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::cached_vec (const vec<T, L>& value)
+    : v(value), unit(T(0)), n2(0), n(0), valid(0u)
+{
+    static_assert(std::is_floating_point<T>::value,
+                  "cached_vec requires a floating point type");
+} //cached_vec(vec)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::cached_vec (T c0, T c1)
+    : cached_vec(vec<T, L>(c0, c1))
+{
+} //cached_vec(T, T)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::cached_vec (T c0, T c1, T c2)
+    : cached_vec(vec<T, L>(c0, c1, c2))
+{
+} //cached_vec(T, T, T)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::cached_vec (T c0, T c1, T c2, T c3)
+    : cached_vec(vec<T, L>(c0, c1, c2, c3))
+{
+} //cached_vec(T, T, T, T)
+
+template <typename T, unsigned int L>
+const vec<T, L>& cached_vec<T, L>::value () const
+{
+    return v;
+} //value()
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::operator const vec<T, L>& () const
+{
+    return v;
+} //operator const vec&()
+
+template <typename T, unsigned int L>
+const T& cached_vec<T, L>::operator[] (const unsigned int index) const
+{
+    return v[index];
+} //operator[](uint) const
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref cached_vec<T, L>::operator[] (
+    const unsigned int index)
+{
+    return component_ref(*this, index);
+} //operator[](uint)
+
+template <typename T, unsigned int L>
+void cached_vec<T, L>::set (const unsigned int index, const T value)
+{
+    if(index >= L)
+        throw std::out_of_range("index too large");
+    valid = 0u;
+    v[index] = value;
+} //set(uint, T)
+
+template <typename T, unsigned int L>
+const cached_vec<T, L>& cached_vec<T, L>::operator= (const vec<T, L>& value)
+{
+    valid = 0u;
+    v = value;
+    return *this;
+} //operator=(vec)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>& cached_vec<T, L>::operator+= (const vec<T, L>& value)
+{
+    valid = 0u;
+    for(unsigned int i = 0; i < L; i++)
+        v[i] = v[i] + value[i];
+    return *this;
+} //operator+=(vec)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>& cached_vec<T, L>::operator-= (const vec<T, L>& value)
+{
+    valid = 0u;
+    for(unsigned int i = 0; i < L; i++)
+        v[i] = v[i] - value[i];
+    return *this;
+} //operator-=(vec)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>& cached_vec<T, L>::operator*= (const vec<T, L>& value)
+{
+    valid = 0u;
+    for(unsigned int i = 0; i < L; i++)
+        v[i] = value[i] * v[i];
+    return *this;
+} //operator*=(vec)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>& cached_vec<T, L>::operator*= (const T& s)
+{
+    for(unsigned int i = 0; i < L; i++)
+        v[i] = v[i] * s;
+
+    // |s v| = |s| |v|. The scaled norm is kept only if both the old and the
+    // new norm lie where their square neither overflows nor loses bits to
+    // underflow (or if s == 0), so it agrees with a recomputed norm2() and
+    // is no less accurate than a recomputation. Otherwise everything is
+    // recomputed on the next read.
+    const T low = std::sqrt(std::numeric_limits<T>::min()
+                            / std::numeric_limits<T>::epsilon());
+    const T high = std::sqrt(std::numeric_limits<T>::max());
+    const T scaled = n * std::abs(s);
+    if((valid & norm_valid) && n >= low && n <= high
+       && ((scaled >= low && scaled <= high) || s == T(0)))
+    {
+        n = scaled;
+        // direction is unchanged for s > 0 and flipped for s < 0 (and
+        // undefined for s == 0, as for the zero vector)
+        if(s < T(0))
+        {
+            for(unsigned int i = 0; i < L; i++)
+                unit[i] = -unit[i];
+        }
+        valid &= s != T(0) ? norm_valid | unit_valid : norm_valid;
+    }
+    else
+        valid = 0u;
+    return *this;
+} //operator*=(T)
+
+template <typename T, unsigned int L>
+cached_vec<T, L> cached_vec<T, L>::operator* (const T& s) const
+{
+    cached_vec<T, L> temp = *this;
+    temp *= s;
+    return temp;
+} //operator*(T)
+
+template <typename T, unsigned int L>
+cached_vec<T, L> cached_vec<T, L>::operator- () const
+{
+    cached_vec<T, L> temp = *this;
+    for(unsigned int i = 0; i < L; i++)
+    {
+        temp.v[i] = -v[i];
+        temp.unit[i] = -unit[i];
+    }
+    return temp;
+} //operator-()
+
+template <typename T, unsigned int L>
+T cached_vec<T, L>::norm2 () const
+{
+    return (valid & norm2_valid) ? n2 : update_norm2();
+} //norm2()
+
+template <typename T, unsigned int L>
+T cached_vec<T, L>::norm () const
+{
+    return (valid & norm_valid) ? n : update_norm();
+} //norm()
+
+template <typename T, unsigned int L>
+const vec<T, L>& cached_vec<T, L>::normalize () const
+{
+    return (valid & unit_valid) ? unit : update_unit();
+} //normalize()
+
+template <typename T, unsigned int L>
+T cached_vec<T, L>::update_norm2 () const
+{
+    // same summation order as vec::norm()
+    T result = 0;
+    for(unsigned int i = 0; i < L; i++)
+        result = v[i] * v[i] + result;
+    n2 = result;
+    valid |= norm2_valid;
+    return n2;
+} //update_norm2()
+
+template <typename T, unsigned int L>
+T cached_vec<T, L>::update_norm () const
+{
+    n = std::sqrt(norm2());
+    valid |= norm_valid;
+    return n;
+} //update_norm()
+
+template <typename T, unsigned int L>
+const vec<T, L>& cached_vec<T, L>::update_unit () const
+{
+    const T length = norm();
+    for(unsigned int i = 0; i < L; i++)
+        unit[i] = v[i] / length;
+    valid |= unit_valid;
+    return unit;
+} //update_unit()
+
+template <typename T, unsigned int L>
+void cached_vec<T, L>::invalidate ()
+{
+    valid = 0u;
+} //invalidate()
+
+template <typename T, unsigned int L>
+unsigned int cached_vec<T, L>::length () const
+{
+    return L;
+} //length()
+
+//=============================================//
+// component_ref
+//=============================================//
+template <typename T, unsigned int L>
+cached_vec<T, L>::component_ref::component_ref (cached_vec& target,
+                                                const unsigned int at)
+    : owner(target), index(at)
+{
+} //component_ref(cached_vec, uint)
+
+template <typename T, unsigned int L>
+cached_vec<T, L>::component_ref::operator T () const
+{
+    return owner.v[index];
+} //operator T()
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref&
+cached_vec<T, L>::component_ref::operator= (const T value)
+{
+    owner.valid = 0u;
+    owner.v[index] = value;
+    return *this;
+} //operator=(T)
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref&
+cached_vec<T, L>::component_ref::operator= (const component_ref& other)
+{
+    return *this = T(other);
+} //operator=(component_ref)
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref&
+cached_vec<T, L>::component_ref::operator+= (const T value)
+{
+    return *this = owner.v[index] + value;
+} //operator+=(T)
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref&
+cached_vec<T, L>::component_ref::operator-= (const T value)
+{
+    return *this = owner.v[index] - value;
+} //operator-=(T)
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref&
+cached_vec<T, L>::component_ref::operator*= (const T value)
+{
+    return *this = owner.v[index] * value;
+} //operator*=(T)
+
+template <typename T, unsigned int L>
+typename cached_vec<T, L>::component_ref&
+cached_vec<T, L>::component_ref::operator/= (const T value)
+{
+    return *this = owner.v[index] / value;
+} //operator/=(T)
+
+} //namespace sbt
@@ -51,7 +51,7 @@ namespace sbt
 template <typename T, unsigned int L>
 vec_base<T, L>::vec_base ()
 {
-    for(unsigned int i; i < length(); i++)
+    for(unsigned int i = 0u; i < length(); i++)
         d[i] = 0;
 } //vec()
 
@@ -235,7 +235,6 @@ T vec<T, L>::norm() const
     for(unsigned int i = 0; i < L; i++)
     {
         result = ((*this)[i])*((*this)[i]) + result;
-        std::cerr<<"result: "<<result<<std::endl;
     }
     return std::sqrt(result);
 } //norm()
@@ -0,0 +1,182 @@
+#ifndef vec_ingest_HPP_
+#define vec_ingest_HPP_
+
+/////////////////////////////////////////////////
+// vecIngest.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// Parsing numeric text (CSV, ASCII PLY, OBJ) straight into vec<T, L> arrays
+// without going through iostreams.
+//
+// All parse functions work on a [first, last) character range, so the text
+// can come from load_text(), a memory mapped file, or anything else that
+// keeps the bytes in memory. The range is cut into one chunk per thread, each
+// cut moved forward to the next line start. A first pass counts the data
+// lines of every chunk, the output is resized once, and a second pass parses
+// each chunk straight into its place, so the result is the same as a single
+// threaded parse and is never held twice in memory. Line ends are found with
+// std::memchr, which the C library implements with SIMD scanning.
+//
+// A data line is any line that is not blank and does not start with '#'.
+// Fields are separated by one ',' or ';', by blanks (spaces and tabs), or
+// by one ',' or ';' with blanks around it. Two ',' or ';' in a row enclose an
+// empty field, which is counted when skipping to `column` and is an error in
+// the L fields that are read. Only the L fields starting at `column` are
+// read, anything after them is ignored.
+//
+/////////////////////////////////////////////////
+
+
+//=============================================//
+// INCLUDE vec (prototype, implementation and aliases)
+//=============================================//
+#include "vecDefault.hpp"
+#include "vecSoa.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace sbt
+{
+
+/////////////////////////////////////////////////
+/// \brief Read a whole file into memory
+///
+/// \param [in] path file to read
+/// \param [out] buffer receives the file contents
+/// \exception std::runtime_error if the file cannot be read
+///
+/////////////////////////////////////////////////
+void load_text (const char* path, std::vector<char>& buffer);
+
+/////////////////////////////////////////////////
+/// \brief Parse one number (integer or floating point) from text
+///
+/// Works like std::from_chars: no leading whitespace is skipped and the
+/// locale is not consulted. Floating point values with at most 19 significant
+/// digits and a decimal exponent in [-22, 22] are converted exactly; other
+/// values (and inf/nan) fall back to std::from_chars where the standard
+/// library has it, otherwise to strtod_l with the "C" locale. float values
+/// are rounded through double.
+///
+/// \param first start of the text
+/// \param last end of the text
+/// \param [out] value parsed value
+/// \return pointer past the number, or `first` if no number was found
+///
+/////////////////////////////////////////////////
+template <typename T>
+const char* parse_number (const char* first, const char* last, T& value);
+
+/////////////////////////////////////////////////
+/// \brief Parse one vec per data line and append them to `out`
+///
+/// \param first start of the text
+/// \param last end of the text
+/// \param [out] out array the vecs are appended to
+/// \param column index of the first field to read on every line
+/// \param threads number of threads, 0 = hardware concurrency
+/// \return number of vecs appended
+/// \exception std::invalid_argument if a data line has too few, empty or
+///     malformed fields
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+std::size_t parse_vecs (const char* first, const char* last,
+                        std::vector<vec<T, L> >& out,
+                        unsigned int column = 0u, unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Parse one vec per data line into component arrays
+/// \see parse_vecs(const char*, const char*, std::vector<vec<T, L> >&,
+///     unsigned int, unsigned int)
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+std::size_t parse_vecs (const char* first, const char* last,
+                        vec_soa<T, L>& out,
+                        unsigned int column = 0u, unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Parse CSV (or whitespace separated) text
+///
+/// Same as parse_vecs() (`out` may be either array type), except that the
+/// first data line is skipped as a header if its field at index `column` is
+/// not a number.
+///
+/////////////////////////////////////////////////
+template <typename Out>
+std::size_t parse_csv (const char* first, const char* last, Out& out,
+                       unsigned int column = 0u, unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Parse the vertex element of an ASCII PLY file
+///
+/// \param first start of the text (beginning of the file)
+/// \param last end of the text
+/// \param [out] out std::vector<vec<T, L> > or vec_soa<T, L> the vecs are
+///     appended to
+/// \param property name of the vertex property to start reading at, e.g.
+///     "x" for positions or "nx" for normals
+/// \param threads number of threads, 0 = hardware concurrency
+/// \return number of vecs appended
+/// \exception std::invalid_argument if the header is not ASCII PLY, has no
+///     vertex element or no such property, has a list property at or before
+///     `property`, or the vertex data is malformed
+///
+/////////////////////////////////////////////////
+template <typename Out>
+std::size_t parse_ply (const char* first, const char* last, Out& out,
+                       const char* property = "x", unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Parse the lines of a Wavefront OBJ file with a given tag
+///
+/// \param first start of the text
+/// \param last end of the text
+/// \param tag line tag to read, e.g. "v" for positions or "vn" for normals
+/// \param [out] out std::vector<vec<T, L> > or vec_soa<T, L> the vecs are
+///     appended to
+/// \param threads number of threads, 0 = hardware concurrency
+/// \return number of vecs appended
+///
+/////////////////////////////////////////////////
+template <typename Out>
+std::size_t parse_obj (const char* first, const char* last, const char* tag,
+                       Out& out, unsigned int threads = 0u);
+
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecIngest.inl"
+
+#endif //vec_ingest_HPP_
@@ -0,0 +1,726 @@
+/////////////////////////////////////////////////
+//vecIngest.inl
+// Note: do not include this file directly, include vecIngest.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+#include "vecParallel.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// locale independent conversion for the slow path of parse_number()
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SBT_INGEST_FROM_CHARS
+#elif defined(_MSC_VER)
+#include <locale.h>
+#define SBT_INGEST_STRTOD_L
+#define SBT_INGEST_LOCALE _locale_t
+#define SBT_INGEST_C_LOCALE _create_locale(LC_NUMERIC, "C")
+#define SBT_INGEST_STRTOD _strtod_l
+#else
+#include <locale.h>
+#include <stdlib.h>
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
+#define SBT_INGEST_STRTOD_L
+#define SBT_INGEST_LOCALE locale_t
+#define SBT_INGEST_C_LOCALE newlocale(LC_NUMERIC_MASK, "C", (locale_t)0)
+#define SBT_INGEST_STRTOD strtod_l
+#endif
+
+namespace sbt
+{
+
+//=============================================//
+// Helpers
+//=============================================//
+namespace detail
+{
+
+inline bool is_digit (char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool is_field_delimiter (char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+inline bool is_blank (char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool is_separator (char c)
+{
+    return c == ',' || c == ';';
+}
+
+// start of the next field after the end of a field at p: blanks, at most
+// one ',' or ';', then blanks again. A ',' or ';' at the result means the
+// next field is empty.
+inline const char* next_field (const char* p, const char* e)
+{
+    while(p != e && is_blank(*p))
+        p++;
+    if(p != e && is_separator(*p))
+        p++;
+    while(p != e && is_blank(*p))
+        p++;
+    return p;
+} //next_field(char*, char*)
+
+// end of the line starting at p (position of '\n' or last)
+inline const char* line_end (const char* p, const char* last)
+{
+    const void* nl = std::memchr(p, '\n', last - p);
+    return nl ? static_cast<const char*>(nl) : last;
+}
+
+// start of the first line that begins at or after p
+inline const char* next_line (const char* first, const char* p,
+                              const char* last)
+{
+    if(p <= first)
+        return first;
+    if(p >= last)
+        return last;
+    const char* e = line_end(p - 1, last);
+    return e == last ? last : e + 1;
+}
+
+#ifdef SBT_INGEST_FROM_CHARS
+// whether the decimal number [first, last) is too large (rather than too
+// small) for a double, going by its decimal magnitude
+inline bool float_overflows (const char* first, const char* last)
+{
+    const char* p = first;
+    if(p != last && (*p == '-' || *p == '+'))
+        p++;
+    while(p != last && *p == '0')
+        p++;
+    long magnitude = 0;
+    for(; p != last && is_digit(*p); p++)
+        magnitude++;
+    if(p != last && *p == '.')
+    {
+        p++;
+        if(magnitude == 0)
+            for(; p != last && *p == '0'; p++)
+                magnitude--;
+        while(p != last && is_digit(*p))
+            p++;
+    }
+    if(p != last && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        const bool negative = p != last && *p == '-';
+        if(p != last && (*p == '-' || *p == '+'))
+            p++;
+        long e = 0;
+        for(; p != last && is_digit(*p); p++)
+            if(e < 100000)
+                e = e * 10 + (*p - '0');
+        magnitude += negative ? -e : e;
+    }
+    return magnitude > 0;
+} //float_overflows(char*, char*)
+#endif
+
+// slow path: copy the token and convert it with the "C" locale, whatever
+// the global locale is
+inline const char* parse_float_fallback (const char* first, const char* last,
+                                         double& value)
+{
+    const char* p = first;
+    while(p != last && !is_field_delimiter(*p) && *p != '\n')
+        p++;
+
+#ifdef SBT_INGEST_FROM_CHARS
+    // from_chars does not accept a leading '+'
+    const char* start = (first != p && *first == '+') ? first + 1 : first;
+    const std::from_chars_result r = std::from_chars(start, p, value);
+    if(r.ec == std::errc::result_out_of_range)
+    {
+        // value is left untouched; give +-inf or +-0 like strtod
+        const double big = float_overflows(start, r.ptr)
+                         ? std::numeric_limits<double>::infinity() : 0.0;
+        value = *start == '-' ? -big : big;
+    }
+    return r.ec == std::errc::invalid_argument ? first : r.ptr;
+#else
+    static const SBT_INGEST_LOCALE c_locale = SBT_INGEST_C_LOCALE;
+    std::string token(first, p);
+    char* end = 0;
+    value = SBT_INGEST_STRTOD(token.c_str(), &end, c_locale);
+    return first + (end - token.c_str());
+#endif
+} //parse_float_fallback(char*, char*, double&)
+
+inline const char* parse_float (const char* first, const char* last,
+                                double& value)
+{
+    // powers of ten exactly representable as double
+    static const double pow10[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+        1e22
+    };
+
+    const char* p = first;
+    bool negative = false;
+    if(p != last && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+    if(p != last && (*p == 'i' || *p == 'I' || *p == 'n' || *p == 'N'))
+        return parse_float_fallback(first, last, value);
+
+    unsigned long long mantissa = 0;
+    int digits = 0;         // significant digits kept in mantissa
+    int exponent = 0;       // decimal exponent applied to mantissa
+    bool truncated = false; // more than 19 significant digits
+    bool any = false;
+
+    for(; p != last && is_digit(*p); p++)
+    {
+        any = true;
+        if(digits < 19)
+        {
+            mantissa = mantissa * 10u + (*p - '0');
+            if(mantissa)
+                digits++;
+        }
+        else
+        {
+            truncated = true;
+            exponent++;
+        }
+    }
+    if(p != last && *p == '.')
+    {
+        p++;
+        for(; p != last && is_digit(*p); p++)
+        {
+            any = true;
+            if(digits < 19)
+            {
+                mantissa = mantissa * 10u + (*p - '0');
+                if(mantissa)
+                    digits++;
+                exponent--;
+            }
+            else
+                truncated = true;
+        }
+    }
+    if(!any)
+        return first;
+
+    // exponent is only consumed if at least one digit follows it
+    if(p != last && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool negative_exponent = false;
+        if(q != last && (*q == '-' || *q == '+'))
+        {
+            negative_exponent = *q == '-';
+            q++;
+        }
+        if(q != last && is_digit(*q))
+        {
+            int e = 0;
+            for(; q != last && is_digit(*q); q++)
+                if(e < 100000)
+                    e = e * 10 + (*q - '0');
+            exponent += negative_exponent ? -e : e;
+            p = q;
+        }
+    }
+
+    if(mantissa == 0)
+    {
+        value = negative ? -0.0 : 0.0;
+        return p;
+    }
+    if(truncated || mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+    {
+        parse_float_fallback(first, p, value);
+        return p;
+    }
+
+    value = static_cast<double>(mantissa);
+    value = exponent < 0 ? value / pow10[-exponent] : value * pow10[exponent];
+    if(negative)
+        value = -value;
+    return p;
+} //parse_float(char*, char*, double)
+
+template <typename T>
+const char* parse_number (const char* first, const char* last, T& value,
+                          std::true_type /*is_integral*/)
+{
+    const char* p = first;
+    bool negative = false;
+    if(p != last && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        if(negative && !std::is_signed<T>::value)
+            return first;
+        p++;
+    }
+
+    // magnitude limit, |min| for negative signed values
+    const unsigned long long limit = negative
+        ? static_cast<unsigned long long>(std::numeric_limits<T>::max()) + 1u
+        : static_cast<unsigned long long>(std::numeric_limits<T>::max());
+
+    unsigned long long magnitude = 0;
+    const char* digits = p;
+    for(; p != last && is_digit(*p); p++)
+    {
+        const unsigned int d = *p - '0';
+        if(magnitude > (limit - d) / 10u)
+            return first;
+        magnitude = magnitude * 10u + d;
+    }
+    if(p == digits)
+        return first;
+
+    if(negative && magnitude)
+        value = static_cast<T>(-static_cast<long long>(magnitude - 1u) - 1);
+    else
+        value = static_cast<T>(magnitude);
+    return p;
+} //parse_number(char*, char*, T&, true_type)
+
+template <typename T>
+const char* parse_number (const char* first, const char* last, T& value,
+                          std::false_type /*is_integral*/)
+{
+    double d;
+    const char* p = parse_float(first, last, d);
+    if(p != first)
+        value = static_cast<T>(d);
+    return p;
+} //parse_number(char*, char*, T&, false_type)
+
+// start of the fields of the line [p, e), or 0 if it is not a data line:
+// blank, a comment, or (if `tag` is given) not starting with `tag`
+inline const char* data_fields (const char* p, const char* e,
+                                const char* tag, std::size_t tag_length)
+{
+    while(p != e && is_blank(*p))
+        p++;
+    if(p == e || *p == '#')
+        return 0;
+    if(tag_length)
+    {
+        if(std::size_t(e - p) <= tag_length
+           || std::memcmp(p, tag, tag_length) != 0
+           || !is_blank(p[tag_length]))
+            return 0;
+        p += tag_length;
+    }
+    return p;
+} //data_fields(char*, char*, char*, size_t)
+
+// number of data lines in [first, last)
+inline std::size_t count_lines (const char* first, const char* last,
+                                const char* tag, std::size_t tag_length)
+{
+    std::size_t count = 0;
+    const char* p = first;
+    while(p != last)
+    {
+        const char* e = line_end(p, last);
+        if(data_fields(p, e, tag, tag_length))
+            count++;
+        p = e == last ? last : e + 1;
+    }
+    return count;
+} //count_lines(char*, char*, char*, size_t)
+
+// parse every data line in [first, last), passing each vec to put
+template <typename T, unsigned int L, typename Put>
+void parse_lines (const char* first, const char* last,
+                  const char* tag, std::size_t tag_length,
+                  unsigned int column, Put put)
+{
+    vec<T, L> v(T(0));
+    const char* p = first;
+    while(p != last)
+    {
+        const char* e = line_end(p, last);
+        const char* next = e == last ? last : e + 1;
+
+        p = data_fields(p, e, tag, tag_length);
+        if(!p)
+        {
+            p = next;
+            continue;
+        }
+
+        for(unsigned int i = 0; i < column + L; i++)
+        {
+            // p is at the first non-blank of the line (or after the tag)
+            if(i > 0 || tag_length)
+                p = next_field(p, e);
+            if(p == e)
+                throw std::invalid_argument("too few fields on line");
+
+            if(i < column)
+            {
+                while(p != e && !is_field_delimiter(*p))
+                    p++;
+                continue;
+            }
+            if(is_separator(*p))
+                throw std::invalid_argument("empty field on line");
+            const char* q = sbt::parse_number(p, e, v[i - column]);
+            if(q == p || (q != e && !is_field_delimiter(*q)))
+                throw std::invalid_argument("malformed number on line");
+            p = q;
+        }
+        put(v);
+        p = next;
+    }
+} //parse_lines(char*, char*, char*, size_t, uint, Put)
+
+template <typename T, unsigned int L>
+void store (std::vector<vec<T, L> >& out, std::size_t n, const vec<T, L>& v)
+{
+    out[n] = v;
+} //store(vector, size_t, vec)
+
+template <typename T, unsigned int L>
+void store (vec_soa<T, L>& out, std::size_t n, const vec<T, L>& v)
+{
+    for(unsigned int i = 0; i < L; i++)
+        out.c[i][n] = v[i];
+} //store(vec_soa, size_t, vec)
+
+// chunked parse of [first, last), see "General design comments" in the header
+template <typename T, unsigned int L, typename Out>
+std::size_t parse_chunked (const char* first, const char* last,
+                           const char* tag, unsigned int column,
+                           unsigned int threads, Out& out)
+{
+    const std::size_t before = out.size();
+    const std::size_t bytes = last - first;
+    const std::size_t tag_length = tag ? std::strlen(tag) : 0u;
+
+    threads = thread_count(threads, bytes, std::size_t(1) << 20);
+    if(threads == 1u)
+    {
+        parse_lines<T, L>(first, last, tag, tag_length, column,
+                          [&](const vec<T, L>& v) { out.push_back(v); });
+        return out.size() - before;
+    }
+
+    // count the records of every chunk, then parse each chunk straight into
+    // its place in out
+    std::vector<std::size_t> offset(threads + 1u, 0u);
+    parallel_chunks(bytes, threads,
+        [&](std::size_t begin, std::size_t end, unsigned int t)
+        {
+            offset[t + 1u] = count_lines(next_line(first, first + begin, last),
+                                         next_line(first, first + end, last),
+                                         tag, tag_length);
+        });
+    offset[0] = before;
+    for(unsigned int t = 0; t < threads; t++)
+        offset[t + 1u] += offset[t];
+
+    out.resize(offset[threads]);
+    try
+    {
+        parallel_chunks(bytes, threads,
+            [&](std::size_t begin, std::size_t end, unsigned int t)
+            {
+                std::size_t n = offset[t];
+                parse_lines<T, L>(next_line(first, first + begin, last),
+                                  next_line(first, first + end, last),
+                                  tag, tag_length, column,
+                                  [&](const vec<T, L>& v)
+                                  { store(out, n++, v); });
+            });
+    }
+    catch(...)
+    {
+        out.resize(before);
+        throw;
+    }
+    return out.size() - before;
+} //parse_chunked(char*, char*, char*, uint, uint, Out&)
+
+template <typename T, unsigned int L>
+std::size_t parse_tagged (const char* first, const char* last,
+                          const char* tag, unsigned int threads,
+                          std::vector<vec<T, L> >& out)
+{
+    return parse_chunked<T, L>(first, last, tag, 0u, threads, out);
+} //parse_tagged(char*, char*, char*, uint, vector)
+
+template <typename T, unsigned int L>
+std::size_t parse_tagged (const char* first, const char* last,
+                          const char* tag, unsigned int threads,
+                          vec_soa<T, L>& out)
+{
+    return parse_chunked<T, L>(first, last, tag, 0u, threads, out);
+} //parse_tagged(char*, char*, char*, uint, vec_soa)
+
+// first line of the text that is neither blank nor a comment
+inline const char* first_data_line (const char* first, const char* last)
+{
+    const char* p = first;
+    while(p != last)
+    {
+        const char* e = line_end(p, last);
+        const char* q = p;
+        while(q != e && is_blank(*q))
+            q++;
+        if(q != e && *q != '#')
+            return p;
+        p = e == last ? last : e + 1;
+    }
+    return last;
+} //first_data_line(char*, char*)
+
+// start of field `index` of the line [p, e), or e if there are fewer fields
+inline const char* field_at (const char* p, const char* e, unsigned int index)
+{
+    while(p != e && is_blank(*p))
+        p++;
+    for(unsigned int i = 0; i < index && p != e; i++)
+    {
+        while(p != e && !is_field_delimiter(*p))
+            p++;
+        p = next_field(p, e);
+    }
+    return p;
+} //field_at(char*, char*, uint)
+
+// PLY header word at p, advancing p past it
+inline std::string next_word (const char*& p, const char* e)
+{
+    while(p != e && is_blank(*p))
+        p++;
+    const char* start = p;
+    while(p != e && !is_blank(*p))
+        p++;
+    return std::string(start, p);
+} //next_word(char*&, char*)
+
+} //namespace detail
+
+
+//=============================================//
+// Public interface
+//=============================================//
+
+inline void load_text (const char* path, std::vector<char>& buffer)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if(!file)
+        throw std::runtime_error(std::string("could not open ") + path);
+
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    buffer.resize(static_cast<std::size_t>(size));
+    if(size > 0 && !file.read(&buffer[0], size))
+        throw std::runtime_error(std::string("could not read ") + path);
+} //load_text(char*, vector<char>)
+
+template <typename T>
+const char* parse_number (const char* first, const char* last, T& value)
+{
+    static_assert(std::is_arithmetic<T>::value,
+                  "parse_number requires an arithmetic type");
+    return detail::parse_number(first, last, value,
+                                typename std::is_integral<T>::type());
+} //parse_number(char*, char*, T&)
+
+template <typename T, unsigned int L>
+std::size_t parse_vecs (const char* first, const char* last,
+                        std::vector<vec<T, L> >& out,
+                        unsigned int column, unsigned int threads)
+{
+    return detail::parse_chunked<T, L>(first, last, 0, column, threads, out);
+} //parse_vecs(char*, char*, vector, uint, uint)
+
+template <typename T, unsigned int L>
+std::size_t parse_vecs (const char* first, const char* last,
+                        vec_soa<T, L>& out,
+                        unsigned int column, unsigned int threads)
+{
+    return detail::parse_chunked<T, L>(first, last, 0, column, threads, out);
+} //parse_vecs(char*, char*, vec_soa, uint, uint)
+
+template <typename Out>
+std::size_t parse_csv (const char* first, const char* last, Out& out,
+                       unsigned int column, unsigned int threads)
+{
+    const char* p = detail::first_data_line(first, last);
+    const char* e = detail::line_end(p, last);
+
+    // the first line is a header if the first field that would be read is
+    // there but is not a number (an empty field is an error, not a header)
+    const char* q = detail::field_at(p, e, column);
+    double value;
+    const char* r = q == e ? q : parse_number(q, e, value);
+    if(q != e && !detail::is_separator(*q)
+       && (r == q || (r != e && !detail::is_field_delimiter(*r))))
+        p = e == last ? last : e + 1;
+    return parse_vecs(p, last, out, column, threads);
+} //parse_csv(char*, char*, Out&, uint, uint)
+
+template <typename Out>
+std::size_t parse_ply (const char* first, const char* last, Out& out,
+                       const char* property, unsigned int threads)
+{
+    const char* p = first;
+    std::size_t skip = 0;       // lines of elements before "vertex"
+    std::size_t count = 0;      // number of vertices
+    int column = -1;            // index of `property`
+    int properties = 0;         // properties of "vertex" seen so far
+    bool ascii = false;
+    bool vertex = false;        // currently in the "vertex" element
+    bool found = false;         // "vertex" element seen
+    bool list = false;          // list property at or before `property`
+    bool header = true;
+
+    for(unsigned int line = 0; header; line++)
+    {
+        if(p == last)
+            throw std::invalid_argument("PLY header is not terminated");
+        const char* e = detail::line_end(p, last);
+        const char* w = p;
+        const std::string keyword = detail::next_word(w, e);
+
+        if(line == 0 && keyword != "ply")
+            throw std::invalid_argument("not a PLY file");
+        else if(keyword == "format")
+            ascii = detail::next_word(w, e) == "ascii";
+        else if(keyword == "element")
+        {
+            const std::string name = detail::next_word(w, e);
+            const std::string n = detail::next_word(w, e);
+            unsigned long long elements = 0;
+            if(parse_number(n.data(), n.data() + n.size(), elements)
+               != n.data() + n.size())
+                throw std::invalid_argument("malformed PLY element count");
+
+            vertex = name == "vertex";
+            if(vertex)
+            {
+                found = true;
+                count = static_cast<std::size_t>(elements);
+            }
+            else if(!found)
+                skip += static_cast<std::size_t>(elements);
+        }
+        else if(keyword == "property" && vertex)
+        {
+            const std::string type = detail::next_word(w, e);
+            if(type == "list")
+            {
+                detail::next_word(w, e);
+                detail::next_word(w, e);
+                // lists are variable width, the columns after them move
+                if(column < 0)
+                    list = true;
+            }
+            if(detail::next_word(w, e) == property && column < 0)
+                column = properties;
+            properties++;
+        }
+        else if(keyword == "end_header")
+            header = false;
+
+        p = e == last ? last : e + 1;
+    }
+
+    if(!ascii)
+        throw std::invalid_argument("only ASCII PLY files are supported");
+    if(!found)
+        throw std::invalid_argument("PLY file has no vertex element");
+    if(column < 0)
+        throw std::invalid_argument(std::string("PLY vertex has no property ")
+                                    + property);
+    if(list)
+        throw std::invalid_argument("PLY list properties at or before the "
+                                    "requested vertex property are not "
+                                    "supported");
+
+    // skip elements stored before the vertices, then find the end of the
+    // vertex block
+    for(; skip && p != last; skip--)
+    {
+        p = detail::line_end(p, last);
+        if(p != last)
+            p++;
+    }
+    const char* e = p;
+    for(std::size_t n = count; n && e != last; n--)
+    {
+        e = detail::line_end(e, last);
+        if(e != last)
+            e++;
+    }
+
+    const std::size_t parsed = parse_vecs(p, e, out, column, threads);
+    if(parsed != count)
+        throw std::invalid_argument("PLY vertex count does not match header");
+    return parsed;
+} //parse_ply(char*, char*, Out&, char*, uint)
+
+template <typename Out>
+std::size_t parse_obj (const char* first, const char* last, const char* tag,
+                       Out& out, unsigned int threads)
+{
+    return detail::parse_tagged(first, last, tag, threads, out);
+} //parse_obj(char*, char*, char*, Out&, uint)
+
+} //namespace sbt
@@ -0,0 +1,193 @@
+#ifndef vec_morton_HPP_
+#define vec_morton_HPP_
+
+/////////////////////////////////////////////////
+// vecMorton.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// Morton (Z-order) codes interleave the bits of the components of an integer
+// vector, so that points that are close in space usually get close codes.
+// Sorting an array of points by Morton code makes later passes over the
+// array read memory mostly in order.
+//
+// 2-d codes use all 32 bits of each component, 3-d codes use the low 21 bits
+// of each component; both fit in an unsigned long long. When compiled with
+// BMI2 (e.g. -mbmi2 or -march=haswell) the interleaving uses pdep/pext,
+// otherwise the usual shift-and-mask sequence. Define SBT_NO_BMI2 to force
+// the latter (pdep/pext are slow microcode on AMD CPUs before Zen 3).
+//
+// morton_sort() quantizes floating point vecs to the bounding box of the
+// array, then sorts (key, index) pairs with a parallel LSD radix sort (8 bits
+// per pass, passes over bytes that are the same for every key are skipped)
+// and finally gathers the vecs into the new order.
+//
+/////////////////////////////////////////////////
+
+
+//=============================================//
+// INCLUDE vec (prototype, implementation and aliases)
+//=============================================//
+#include "vecDefault.hpp"
+#include "vecSoa.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace sbt
+{
+
+/////////////////////////////////////////////////
+/// \brief Number of bits of each component used in an L-d Morton code
+///
+/// Only defined for L = 2 (32 bits) and L = 3 (21 bits).
+///
+/////////////////////////////////////////////////
+template <unsigned int L>
+struct morton_bits;
+
+template <>
+struct morton_bits<2u>
+{
+    static const unsigned int value = 32u;
+};
+
+template <>
+struct morton_bits<3u>
+{
+    static const unsigned int value = 21u;
+};
+
+/////////////////////////////////////////////////
+/// \brief Morton code of a 2-d vector
+///
+/// \param v vector to encode
+/// \return code with the bits of v[0] at even and v[1] at odd positions
+///
+/////////////////////////////////////////////////
+unsigned long long morton_encode (const vec<unsigned int, 2u>& v);
+
+/////////////////////////////////////////////////
+/// \brief Morton code of a 3-d vector
+///
+/// \param v vector to encode, only the low 21 bits of each component are
+///     used
+/// \return code with the bits of v[0], v[1], v[2] at positions 3k, 3k+1,
+///     3k+2
+///
+/////////////////////////////////////////////////
+unsigned long long morton_encode (const vec<unsigned int, 3u>& v);
+
+/////////////////////////////////////////////////
+/// \brief Morton codes of an array of vectors
+///
+/// \param v array of n vectors
+/// \param n number of vectors
+/// \param [out] codes array of n codes
+///
+/////////////////////////////////////////////////
+template <unsigned int L>
+void morton_encode (const vec<unsigned int, L>* v, std::size_t n,
+                    unsigned long long* codes);
+
+/////////////////////////////////////////////////
+/// \brief Vector with the given Morton code
+///
+/// \param code Morton code
+/// \return vec<unsigned int, L>, L = 2 or 3
+///
+/////////////////////////////////////////////////
+template <unsigned int L>
+vec<unsigned int, L> morton_decode (unsigned long long code);
+
+/////////////////////////////////////////////////
+/// \brief Map a vector inside [lo, hi] onto the integer grid used for
+/// Morton codes
+///
+/// \param p vector to quantize, components outside [lo, hi] are clamped
+/// \param lo lower corner of the bounding box
+/// \param hi upper corner of the bounding box
+/// \return components in [0, 2^morton_bits<L>::value - 1]
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+vec<unsigned int, L> morton_quantize (const vec<T, L>& p, const vec<T, L>& lo,
+                                      const vec<T, L>& hi);
+
+/////////////////////////////////////////////////
+/// \brief Permutation that sorts an array of vectors by Morton code
+///
+/// \param p array of n vectors
+/// \param n number of vectors
+/// \param threads number of threads, 0 = hardware concurrency
+/// \return indices into p, in Morton order (ties keep their input order)
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+std::vector<std::size_t> morton_order (const vec<T, L>* p, std::size_t n,
+                                       unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Permutation that sorts component arrays by Morton code
+/// \see morton_order(const vec<T, L>*, std::size_t, unsigned int)
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+std::vector<std::size_t> morton_order (const vec_soa<T, L>& p,
+                                       unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Reorder an array of vectors into Morton order
+///
+/// Use morton_order() instead if other per-point arrays (normals, colours)
+/// have to be reordered the same way.
+///
+/// \param [in,out] p array to sort
+/// \param threads number of threads, 0 = hardware concurrency
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+void morton_sort (std::vector<vec<T, L> >& p, unsigned int threads = 0u);
+
+/////////////////////////////////////////////////
+/// \brief Reorder component arrays into Morton order
+/// \see morton_sort(std::vector<vec<T, L> >&, unsigned int)
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+void morton_sort (vec_soa<T, L>& p, unsigned int threads = 0u);
+
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecMorton.inl"
+
+#endif //vec_morton_HPP_
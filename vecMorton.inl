@@ -0,0 +1,391 @@
+/////////////////////////////////////////////////
+//vecMorton.inl
+// Note: do not include this file directly, include vecMorton.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+#include "vecParallel.hpp"
+
+#include <algorithm>
+
+#if defined(__BMI2__) && (defined(__x86_64__) || defined(_M_X64)) \
+    && !defined(SBT_NO_BMI2)
+#define SBT_MORTON_BMI2
+#include <immintrin.h>
+#endif
+
+namespace sbt
+{
+
+//=============================================//
+// Helpers
+//=============================================//
+namespace detail
+{
+
+const unsigned long long morton2_mask = 0x5555555555555555ull;
+const unsigned long long morton3_mask = 0x1249249249249249ull;
+
+// spread the low 32 bits of x to the even bit positions
+inline unsigned long long morton_part1by1 (unsigned long long x)
+{
+#ifdef SBT_MORTON_BMI2
+    return _pdep_u64(x, morton2_mask);
+#else
+    x &= 0x00000000ffffffffull;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8))  & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4))  & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x << 2))  & 0x3333333333333333ull;
+    x = (x | (x << 1))  & 0x5555555555555555ull;
+    return x;
+#endif
+} //morton_part1by1(ull)
+
+// inverse of morton_part1by1
+inline unsigned long long morton_compact1by1 (unsigned long long x)
+{
+#ifdef SBT_MORTON_BMI2
+    return _pext_u64(x, morton2_mask);
+#else
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1))  & 0x3333333333333333ull;
+    x = (x | (x >> 2))  & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x >> 4))  & 0x00ff00ff00ff00ffull;
+    x = (x | (x >> 8))  & 0x0000ffff0000ffffull;
+    x = (x | (x >> 16)) & 0x00000000ffffffffull;
+    return x;
+#endif
+} //morton_compact1by1(ull)
+
+// spread the low 21 bits of x to every third bit position
+inline unsigned long long morton_part1by2 (unsigned long long x)
+{
+#ifdef SBT_MORTON_BMI2
+    return _pdep_u64(x, morton3_mask);
+#else
+    x &= 0x00000000001fffffull;
+    x = (x | (x << 32)) & 0x001f00000000ffffull;
+    x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+    x = (x | (x << 8))  & 0x100f00f00f00f00full;
+    x = (x | (x << 4))  & 0x10c30c30c30c30c3ull;
+    x = (x | (x << 2))  & 0x1249249249249249ull;
+    return x;
+#endif
+} //morton_part1by2(ull)
+
+// inverse of morton_part1by2
+inline unsigned long long morton_compact1by2 (unsigned long long x)
+{
+#ifdef SBT_MORTON_BMI2
+    return _pext_u64(x, morton3_mask);
+#else
+    x &= 0x1249249249249249ull;
+    x = (x | (x >> 2))  & 0x10c30c30c30c30c3ull;
+    x = (x | (x >> 4))  & 0x100f00f00f00f00full;
+    x = (x | (x >> 8))  & 0x001f0000ff0000ffull;
+    x = (x | (x >> 16)) & 0x001f00000000ffffull;
+    x = (x | (x >> 32)) & 0x00000000001fffffull;
+    return x;
+#endif
+} //morton_compact1by2(ull)
+
+template <unsigned int L>
+struct morton_codec;
+
+template <>
+struct morton_codec<2u>
+{
+    static vec<unsigned int, 2u> decode (unsigned long long code)
+    {
+        return vec<unsigned int, 2u>(
+            static_cast<unsigned int>(morton_compact1by1(code)),
+            static_cast<unsigned int>(morton_compact1by1(code >> 1)));
+    }
+};
+
+template <>
+struct morton_codec<3u>
+{
+    static vec<unsigned int, 3u> decode (unsigned long long code)
+    {
+        return vec<unsigned int, 3u>(
+            static_cast<unsigned int>(morton_compact1by2(code)),
+            static_cast<unsigned int>(morton_compact1by2(code >> 1)),
+            static_cast<unsigned int>(morton_compact1by2(code >> 2)));
+    }
+};
+
+} //namespace detail
+
+
+//=============================================//
+// Encoding
+//=============================================//
+
+inline unsigned long long morton_encode (const vec<unsigned int, 2u>& v)
+{
+    return detail::morton_part1by1(v[0])
+        | (detail::morton_part1by1(v[1]) << 1);
+} //morton_encode(uvec2)
+
+inline unsigned long long morton_encode (const vec<unsigned int, 3u>& v)
+{
+    return detail::morton_part1by2(v[0])
+        | (detail::morton_part1by2(v[1]) << 1)
+        | (detail::morton_part1by2(v[2]) << 2);
+} //morton_encode(uvec3)
+
+template <unsigned int L>
+void morton_encode (const vec<unsigned int, L>* v, std::size_t n,
+                    unsigned long long* codes)
+{
+    for(std::size_t i = 0; i < n; i++)
+        codes[i] = morton_encode(v[i]);
+} //morton_encode(uvec*, size_t, ull*)
+
+template <unsigned int L>
+vec<unsigned int, L> morton_decode (unsigned long long code)
+{
+    return detail::morton_codec<L>::decode(code);
+} //morton_decode(ull)
+
+template <typename T, unsigned int L>
+vec<unsigned int, L> morton_quantize (const vec<T, L>& p, const vec<T, L>& lo,
+                                      const vec<T, L>& hi)
+{
+    const double top = static_cast<double>(
+        (1ull << morton_bits<L>::value) - 1u);
+
+    vec<unsigned int, L> q(0u);
+    for(unsigned int i = 0; i < L; i++)
+    {
+        const double extent = static_cast<double>(hi[i])
+                            - static_cast<double>(lo[i]);
+        if(!(extent > 0.0))
+            continue;
+        const double t = (static_cast<double>(p[i])
+                          - static_cast<double>(lo[i])) * (top / extent);
+        // negated comparisons also send NaN to 0
+        if(!(t > 0.0))
+            q[i] = 0u;
+        else if(!(t < top))
+            q[i] = static_cast<unsigned int>(top);
+        else
+            q[i] = static_cast<unsigned int>(t);
+    }
+    return q;
+} //morton_quantize(vec, vec, vec)
+
+
+//=============================================//
+// Sorting helpers
+//=============================================//
+namespace detail
+{
+
+// bounding box of the vecs returned by get(0) ... get(n - 1)
+template <typename T, unsigned int L, typename Get>
+void morton_bounds (std::size_t n, unsigned int threads, Get get,
+                    vec<T, L>& lo, vec<T, L>& hi)
+{
+    std::vector<vec<T, L> > los(threads, get(0)), his(threads, get(0));
+    parallel_chunks(n, threads,
+        [&](std::size_t begin, std::size_t end, unsigned int t)
+        {
+            vec<T, L> l = los[t], h = his[t];
+            for(std::size_t i = begin; i < end; i++)
+            {
+                const vec<T, L> p = get(i);
+                for(unsigned int k = 0; k < L; k++)
+                {
+                    l[k] = p[k] < l[k] ? p[k] : l[k];
+                    h[k] = h[k] < p[k] ? p[k] : h[k];
+                }
+            }
+            los[t] = l;
+            his[t] = h;
+        });
+
+    lo = los[0];
+    hi = his[0];
+    for(unsigned int t = 1; t < threads; t++)
+        for(unsigned int k = 0; k < L; k++)
+        {
+            lo[k] = los[t][k] < lo[k] ? los[t][k] : lo[k];
+            hi[k] = hi[k] < his[t][k] ? his[t][k] : hi[k];
+        }
+} //morton_bounds(size_t, uint, Get, vec&, vec&)
+
+// stable LSD radix sort of idx by keys, 8 bits per pass
+inline void morton_radix_sort (std::vector<unsigned long long>& keys,
+                               std::vector<std::size_t>& idx,
+                               unsigned int threads)
+{
+    const std::size_t n = keys.size();
+
+    // bits that differ between keys; bytes without any are skipped
+    unsigned long long all = ~0ull, any = 0ull;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        all &= keys[i];
+        any |= keys[i];
+    }
+    const unsigned long long varying = all ^ any;
+
+    std::vector<unsigned long long> keys_tmp(n);
+    std::vector<std::size_t> idx_tmp(n);
+    std::vector<std::size_t> counts(threads * 256u);
+
+    for(unsigned int shift = 0; shift < 64u; shift += 8u)
+    {
+        if(((varying >> shift) & 0xffu) == 0u)
+            continue;
+
+        // per-thread histograms of this byte
+        std::fill(counts.begin(), counts.end(), std::size_t(0));
+        parallel_chunks(n, threads,
+            [&](std::size_t begin, std::size_t end, unsigned int t)
+            {
+                std::size_t* c = &counts[t * 256u];
+                for(std::size_t i = begin; i < end; i++)
+                    c[(keys[i] >> shift) & 0xffu]++;
+            });
+
+        // exclusive prefix sum, ordered by (digit, thread) to stay stable
+        std::size_t sum = 0;
+        for(unsigned int d = 0; d < 256u; d++)
+            for(unsigned int t = 0; t < threads; t++)
+            {
+                const std::size_t c = counts[t * 256u + d];
+                counts[t * 256u + d] = sum;
+                sum += c;
+            }
+
+        parallel_chunks(n, threads,
+            [&](std::size_t begin, std::size_t end, unsigned int t)
+            {
+                std::size_t* c = &counts[t * 256u];
+                for(std::size_t i = begin; i < end; i++)
+                {
+                    const std::size_t to = c[(keys[i] >> shift) & 0xffu]++;
+                    keys_tmp[to] = keys[i];
+                    idx_tmp[to] = idx[i];
+                }
+            });
+        keys.swap(keys_tmp);
+        idx.swap(idx_tmp);
+    }
+} //morton_radix_sort(vector, vector, uint)
+
+template <typename T, unsigned int L, typename Get>
+std::vector<std::size_t> morton_order (std::size_t n, unsigned int threads,
+                                       Get get)
+{
+    std::vector<std::size_t> idx(n);
+    if(n == 0)
+        return idx;
+
+    threads = thread_count(threads, n, std::size_t(1) << 16);
+    vec<T, L> lo, hi;
+    morton_bounds<T, L>(n, threads, get, lo, hi);
+
+    std::vector<unsigned long long> keys(n);
+    parallel_chunks(n, threads,
+        [&](std::size_t begin, std::size_t end, unsigned int)
+        {
+            for(std::size_t i = begin; i < end; i++)
+            {
+                keys[i] = morton_encode(morton_quantize(get(i), lo, hi));
+                idx[i] = i;
+            }
+        });
+
+    morton_radix_sort(keys, idx, threads);
+    return idx;
+} //morton_order(size_t, uint, Get)
+
+} //namespace detail
+
+
+//=============================================//
+// Sorting
+//=============================================//
+
+template <typename T, unsigned int L>
+std::vector<std::size_t> morton_order (const vec<T, L>* p, std::size_t n,
+                                       unsigned int threads)
+{
+    return detail::morton_order<T, L>(n, threads,
+        [p](std::size_t i) -> const vec<T, L>& { return p[i]; });
+} //morton_order(vec*, size_t, uint)
+
+template <typename T, unsigned int L>
+std::vector<std::size_t> morton_order (const vec_soa<T, L>& p,
+                                       unsigned int threads)
+{
+    return detail::morton_order<T, L>(p.size(), threads,
+        [&p](std::size_t i) { return p.get(i); });
+} //morton_order(vec_soa, uint)
+
+template <typename T, unsigned int L>
+void morton_sort (std::vector<vec<T, L> >& p, unsigned int threads)
+{
+    if(p.empty())
+        return;
+    const std::vector<std::size_t> order = morton_order(&p[0], p.size(),
+                                                        threads);
+
+    std::vector<vec<T, L> > sorted(p.size());
+    detail::parallel_chunks(p.size(),
+                    detail::thread_count(threads, p.size(), 1u << 16),
+        [&](std::size_t begin, std::size_t end, unsigned int)
+        {
+            for(std::size_t i = begin; i < end; i++)
+                sorted[i] = p[order[i]];
+        });
+    p.swap(sorted);
+} //morton_sort(vector, uint)
+
+template <typename T, unsigned int L>
+void morton_sort (vec_soa<T, L>& p, unsigned int threads)
+{
+    const std::vector<std::size_t> order = morton_order(p, threads);
+
+    vec_soa<T, L> sorted(p.size());
+    detail::parallel_chunks(p.size(),
+                    detail::thread_count(threads, p.size(), 1u << 16),
+        [&](std::size_t begin, std::size_t end, unsigned int)
+        {
+            for(unsigned int k = 0; k < L; k++)
+                for(std::size_t i = begin; i < end; i++)
+                    sorted.c[k][i] = p.c[k][order[i]];
+        });
+    for(unsigned int k = 0; k < L; k++)
+        p.c[k].swap(sorted.c[k]);
+} //morton_sort(vec_soa, uint)
+
+} //namespace sbt
@@ -0,0 +1,84 @@
+#ifndef vec_parallel_HPP_
+#define vec_parallel_HPP_
+
+/////////////////////////////////////////////////
+// vecParallel.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// Small helpers shared by the bulk (array-at-a-time) modules. Work is split
+// into contiguous chunks, one per thread, so that each thread streams through
+// its own region of memory. Exceptions thrown by a worker are re-thrown on the
+// calling thread once all workers have joined.
+//
+/////////////////////////////////////////////////
+
+#include <cstddef>
+
+namespace sbt
+{
+namespace detail
+{
+
+/////////////////////////////////////////////////
+/// \brief Number of threads to use for a bulk operation
+///
+/// \param requested number of threads asked for, 0 = hardware concurrency
+/// \param work number of work items (bytes, elements, ...)
+/// \param grain minimum number of work items worth giving to one thread
+/// \return thread count in [1, requested]
+///
+/////////////////////////////////////////////////
+unsigned int thread_count (unsigned int requested, std::size_t work,
+                           std::size_t grain);
+
+/////////////////////////////////////////////////
+/// \brief Run `fn(begin, end, chunk)` over [0, n) split into `threads`
+/// contiguous chunks
+///
+/// Chunk 0 runs on the calling thread. The first exception thrown by any
+/// chunk is re-thrown after all chunks have finished.
+///
+/// \param n number of items
+/// \param threads number of chunks (see thread_count())
+/// \param fn callable taking (std::size_t, std::size_t, unsigned int)
+///
+/////////////////////////////////////////////////
+template <typename F>
+void parallel_chunks (std::size_t n, unsigned int threads, F fn);
+
+} //namespace detail
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecParallel.inl"
+
+#endif //vec_parallel_HPP_
@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////
+//vecParallel.inl
+// Note: do not include this file directly, include vecParallel.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace sbt
+{
+namespace detail
+{
+
+inline unsigned int thread_count (unsigned int requested, std::size_t work,
+                                  std::size_t grain)
+{
+    if(requested == 0u)
+        requested = std::thread::hardware_concurrency();
+    if(requested == 0u)
+        requested = 1u;
+
+    // never hand out less than `grain` items to a thread
+    std::size_t useful = grain ? work / grain : work;
+    if(useful < 1u)
+        useful = 1u;
+    return useful < requested ? static_cast<unsigned int>(useful) : requested;
+} //thread_count(uint, size_t, size_t)
+
+template <typename F>
+void parallel_chunks (std::size_t n, unsigned int threads, F fn)
+{
+    if(threads <= 1u || n < threads)
+    {
+        fn(std::size_t(0), n, 0u);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1u);
+
+    const std::size_t step = n / threads;
+    for(unsigned int t = 1u; t < threads; t++)
+    {
+        const std::size_t begin = t * step;
+        const std::size_t end = (t + 1u == threads) ? n : begin + step;
+        workers.push_back(std::thread([&fn, &errors, begin, end, t]()
+        {
+            try { fn(begin, end, t); }
+            catch(...) { errors[t] = std::current_exception(); }
+        }));
+    }
+
+    try { fn(std::size_t(0), step, 0u); }
+    catch(...) { errors[0] = std::current_exception(); }
+
+    for(unsigned int t = 0u; t < workers.size(); t++)
+        workers[t].join();
+
+    for(unsigned int t = 0u; t < threads; t++)
+        if(errors[t])
+            std::rethrow_exception(errors[t]);
+} //parallel_chunks(size_t, uint, F)
+
+} //namespace detail
+} //namespace sbt
@@ -0,0 +1,115 @@
+#ifndef vec_soa_HPP_
+#define vec_soa_HPP_
+
+/////////////////////////////////////////////////
+// vecSoa.hpp
+/////////////////////////////////////////////////
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+//General design comments
+//=============================================//
+// vec_soa stores an array of vec<T, L> as L separate component arrays
+// (structure of arrays). Bulk kernels that touch one component at a time
+// (bounds, culling, sorting keys) read contiguous memory this way.
+//
+/////////////////////////////////////////////////
+
+
+//=============================================//
+// INCLUDE vec (prototype, implementation and aliases)
+//=============================================//
+#include "vecDefault.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace sbt
+{
+
+/////////////////////////////////////////////////
+/// \brief An array of vec<T, L> stored as L component arrays
+///
+/////////////////////////////////////////////////
+template <typename T, unsigned int L>
+class vec_soa
+{
+public:
+    /////////////////////////////////////////////////
+    /// \brief Component arrays, `c[i][n]` is component i of element n
+    ///
+    /////////////////////////////////////////////////
+    std::vector<T> c[L];
+
+    vec_soa ();
+    vec_soa (std::size_t n);
+
+    /////////////////////////////////////////////////
+    /// \brief Number of elements
+    ///
+    /////////////////////////////////////////////////
+    std::size_t size () const;
+
+    void resize (std::size_t n);
+    void reserve (std::size_t n);
+    void clear ();
+
+    /////////////////////////////////////////////////
+    /// \brief Append a vec to the end of every component array
+    ///
+    /////////////////////////////////////////////////
+    void push_back (const vec<T, L>& v);
+
+    /////////////////////////////////////////////////
+    /// \brief Gather element n into a vec
+    /// \warning This method does not check the index to be in bounds
+    ///
+    /////////////////////////////////////////////////
+    vec<T, L> get (std::size_t n) const;
+
+    /////////////////////////////////////////////////
+    /// \brief Scatter a vec into element n
+    /// \warning This method does not check the index to be in bounds
+    ///
+    /////////////////////////////////////////////////
+    void set (std::size_t n, const vec<T, L>& v);
+
+    /////////////////////////////////////////////////
+    /// Returns the number of components/dimensions of the elements
+    /// \return L
+    ///
+    /////////////////////////////////////////////////
+    unsigned int length () const;
+}; //class vec_soa
+
+} //namespace sbt
+
+
+//=============================================//
+// INCLUDE IMPLEMENTATION
+//=============================================//
+#include "vecSoa.inl"
+
+#endif //vec_soa_HPP_
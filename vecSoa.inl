@@ -0,0 +1,100 @@
+/////////////////////////////////////////////////
+//vecSoa.inl
+// Note: do not include this file directly, include vecSoa.hpp
+// Copyright (c) 2013, Harrison Leadlay
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//  1) Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////
+
+namespace sbt
+{
+
+template <typename T, unsigned int L>
+vec_soa<T, L>::vec_soa ()
+{
+} //vec_soa()
+
+template <typename T, unsigned int L>
+vec_soa<T, L>::vec_soa (std::size_t n)
+{
+    resize(n);
+} //vec_soa(size_t)
+
+template <typename T, unsigned int L>
+std::size_t vec_soa<T, L>::size () const
+{
+    return c[0].size();
+} //size()
+
+template <typename T, unsigned int L>
+void vec_soa<T, L>::resize (std::size_t n)
+{
+    for(unsigned int i = 0; i < L; i++)
+        c[i].resize(n);
+} //resize(size_t)
+
+template <typename T, unsigned int L>
+void vec_soa<T, L>::reserve (std::size_t n)
+{
+    for(unsigned int i = 0; i < L; i++)
+        c[i].reserve(n);
+} //reserve(size_t)
+
+template <typename T, unsigned int L>
+void vec_soa<T, L>::clear ()
+{
+    for(unsigned int i = 0; i < L; i++)
+        c[i].clear();
+} //clear()
+
+template <typename T, unsigned int L>
+void vec_soa<T, L>::push_back (const vec<T, L>& v)
+{
+    for(unsigned int i = 0; i < L; i++)
+        c[i].push_back(v[i]);
+} //push_back(vec)
+
+template <typename T, unsigned int L>
+vec<T, L> vec_soa<T, L>::get (std::size_t n) const
+{
+    vec<T, L> temp;
+    for(unsigned int i = 0; i < L; i++)
+        temp[i] = c[i][n];
+    return temp;
+} //get(size_t)
+
+template <typename T, unsigned int L>
+void vec_soa<T, L>::set (std::size_t n, const vec<T, L>& v)
+{
+    for(unsigned int i = 0; i < L; i++)
+        c[i][n] = v[i];
+} //set(size_t, vec)
+
+template <typename T, unsigned int L>
+unsigned int vec_soa<T, L>::length () const
+{
+    return L;
+} //length()
+
+} //namespace sbt